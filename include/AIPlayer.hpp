@@ -3,36 +3,31 @@
 
 #include "Player.hpp"
 #include "Board.hpp"
+#include "SearchEngine.hpp"
 #include <utility>
-#include <vector>
-#include <unordered_map>
-#include <cstdint>
+#include <chrono>
 #include <optional> // 加在其他 #include 下方
 
+// 圖形介面使用的 AI 玩家：搜尋交給 15x15 的 SearchEngine
 class AIPlayer : public Player {
 public:
     AIPlayer(char symbol);
+    ~AIPlayer() override { engine.flushTableFile(); }
     void makeMove(Board& board, int& row, int& col) override;
     std::optional<std::pair<int, int>> findBlockingMoveIfThreat(Board& board);
     std::optional<std::pair<int, int>> findWinningMoveIfAvailable(Board& board);
+    std::chrono::milliseconds getTimeLimit() const { return engine.getTimeLimit(); }
+    void setTimeLimit(std::chrono::milliseconds limit) { engine.setTimeLimit(limit); }
+    void setStopFlag(const std::atomic<bool>* flag) { engine.setStopFlag(flag); }
+    SearchResult analyze(Board& board) { return engine.analyze(board); } // 同 makeMove，但不輸出訊息
+    int getDepth() const { return engine.getDepth(); }
+    // 置換表存到檔案，跨盤、跨次執行接續先前的搜尋（見 SearchEngine::attachTableFile）
+    bool setTableFile(const std::string& path) { return engine.attachTableFile(path); }
 
 private:
-    char opponentSymbol;
-
-    // --- 核心演算法 --- //
-    int evaluateBoard(Board& board);
-    std::vector<std::pair<int, int>> generateMoves(Board& board);
-    int minimax(Board& board, int depth, bool maximizing, int alpha, int beta);
-    std::pair<int, int> findBestMove(Board& board);
-    int evaluateLine(const std::vector<char>& line, char currentSymbol);
-    bool hasDangerousThree(Board& board, char checkSymbol);
-    
-
-    // --- Zobrist Hashing --- //
-    uint64_t zobristTable[Board::SIZE][Board::SIZE][2]; // [row][col][0: X, 1: O]
-    std::unordered_map<uint64_t, int> transpositionTable;
-    void initZobrist();
-    uint64_t computeZobristHash(const Board& board);
+    OpeningBook book; // 工作目錄下的 opening.book，沒有就不用（評估權重則讀 eval.params）
+    NnueNetwork network; // 工作目錄下的 eval.nnue，沒有就用棋型表
+    SearchEngine<Board::SIZE> engine;
 };
 
 #endif
@@ -1,22 +1,57 @@
 #ifndef BOARD_HPP
 #define BOARD_HPP
 
-#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
 
-class Board {
+// 每格 2 bits（0: 空, 1: X, 2: O），棋盤大小在編譯期決定：
+// 15x15 剛好 64 bytes、19x19 為 128 bytes，可直接 memcpy 複製
+template <int N>
+class alignas(64) BasicBoard {
 public:
-    static const int SIZE = 15;  
-    Board();
+    static const int SIZE = N;
+    BasicBoard();
 
     bool placePiece(int row, int col, char symbol);
-    char getCell(int row, int col) const;
+    void removePiece(int row, int col); // 搜尋時還原落子用
+    char getCell(int row, int col) const {
+        static const char symbols[4] = {'.', 'X', 'O', '.'};
+        return symbols[code(row, col)];
+    }
+    int cellCode(int row, int col) const { return static_cast<int>(code(row, col)); } // 0: 空, 1: X, 2: O
     bool isFull() const;
-    bool isWin(int row, int col, char symbol) ;
+    bool isWin(int row, int col, char symbol) const;
     void reset(); // ← 加這一行
 
 
 private:
-    std::vector<std::vector<char>> grid;
+    static const int CELLS_PER_WORD = 32;
+    static const int WORDS = (SIZE * SIZE + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+
+    uint64_t bits[WORDS];
+
+    static uint64_t encode(char symbol) { return symbol == 'X' ? 1 : (symbol == 'O' ? 2 : 0); }
+    uint64_t code(int row, int col) const {
+        int idx = row * SIZE + col;
+        return (bits[idx / CELLS_PER_WORD] >> ((idx % CELLS_PER_WORD) * 2)) & 3;
+    }
 };
 
+using Board = BasicBoard<15>;
+using Board19 = BasicBoard<19>;
+
+extern template class BasicBoard<15>;
+extern template class BasicBoard<19>;
+
+// 啟動時依棋盤大小選擇對應的模板實例：f 會收到 std::integral_constant<int, N>
+template <class F>
+decltype(auto) dispatchBoardSize(int size, F&& f) {
+    switch (size) {
+        case 15: return f(std::integral_constant<int, 15>{});
+        case 19: return f(std::integral_constant<int, 19>{});
+        default: throw std::invalid_argument("unsupported board size");
+    }
+}
+
 #endif
@@ -0,0 +1,44 @@
+#ifndef EVALCACHE_HPP
+#define EVALCACHE_HPP
+
+#include "LargePages.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 葉節點評估快取：直接映射、新的直接覆寫舊的（有損），預設大小放得進 L2。
+// 與置換表分開，只存靜態評估，不必管深度與上下界。
+// 每個槽位是單一 64-bit 原子值（高 32 位為 key 的檢查碼、低 32 位為分數），
+// 讀寫各只有一次原子操作，不會讀到寫到一半的項目，多執行緒不需上鎖
+class EvalCache {
+public:
+    explicit EvalCache(size_t sizeKB = 256);
+
+    void resize(size_t sizeKB); // 內容清空
+    void clear();
+    size_t capacity() const { return slotCount; }
+    std::string memoryInfo() const { return buffer.describe(); }
+
+    bool probe(uint64_t key, int& score) const {
+        uint64_t data = slots[key & mask].load(std::memory_order_relaxed);
+        if ((data >> 32) != tag(key)) return false;
+        score = static_cast<int32_t>(static_cast<uint32_t>(data));
+        return true;
+    }
+
+    void store(uint64_t key, int score) {
+        slots[key & mask].store((tag(key) << 32) | static_cast<uint32_t>(score), std::memory_order_relaxed);
+    }
+
+private:
+    LargeBuffer buffer; // 分析用的大快取與置換表走同樣的大頁 / NUMA 配置
+    std::atomic<uint64_t>* slots = nullptr;
+    size_t slotCount = 0;
+    uint64_t mask = 0;
+
+    // 索引用低位元，檢查碼取高 32 位；最低位固定為 1，全 0 的空槽位不會誤中
+    static uint64_t tag(uint64_t key) { return (key >> 32) | 1; }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef FRAMESTATS_HPP
+#define FRAMESTATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// --- 畫面逐幀計時 --- //
+// 把一幀切成幾個連續的階段，各自計時，另外記錄每幀的 draw 呼叫數，以及超出幀率上限的掉幀數。
+// 用法：beginFrame()，每個階段做完呼叫 endPhase()，window.display() 之後呼叫 endFrame()。
+// 不依賴 SFML，計時用 steady_clock；只在畫面執行緒上使用
+class FrameStats {
+public:
+    enum Phase {
+        EVENTS,  // handleEvents：事件處理（含人類落子）
+        UPDATE,  // update：輪到 AI 時的搜尋
+        DRAW,    // 棋盤、棋子與熱度圖
+        RESULT,  // displayResult：結束畫面
+        OVERLAY, // 這個計時面板本身
+        DISPLAY, // window.display()：交換緩衝區，也包含幀率上限的等待
+        PHASE_COUNT
+    };
+    static const char* const PHASE_NAMES[PHASE_COUNT];
+
+    // 幀時間分布：< 4, < 8, < 12, < 17, < 20, < 33, < 50, < 100, >= 100 ms
+    static const int HISTOGRAM_BUCKETS = 9;
+    static const double HISTOGRAM_EDGES_MS[HISTOGRAM_BUCKETS - 1];
+    static int bucketOf(double ms);
+
+    static const int RECENT_FRAMES = 120; // 面板上的平均、最大與分布取最近幾幀
+
+    struct Frame {
+        double phaseMs[PHASE_COUNT] = {};
+        double totalMs = 0;
+        int drawCalls = 0;
+        int dropped = 0; // 這一幀佔掉幾個幀率上限的時間格，減 1
+    };
+
+    // 最近 RECENT_FRAMES 幀的統計
+    struct Summary {
+        int frames = 0;
+        double avgMs = 0, maxMs = 0;
+        double phaseAvgMs[PHASE_COUNT] = {};
+        double phaseMaxMs[PHASE_COUNT] = {};
+        double avgDrawCalls = 0;
+        int dropped = 0;
+        int histogram[HISTOGRAM_BUCKETS] = {};
+    };
+
+    explicit FrameStats(int targetFps = 60);
+    ~FrameStats();
+    FrameStats(const FrameStats&) = delete;
+    FrameStats& operator=(const FrameStats&) = delete;
+
+    // 每秒寫一列彙總（幀數、各階段平均、draw 呼叫、掉幀與分布），覆寫既有檔案
+    bool openCsv(const std::string& path);
+    void closeCsv();
+
+    void beginFrame();
+    void endPhase(Phase phase); // 上一個標記到現在的時間算進 phase
+    void countDraw() { ++current.drawCalls; }
+    void endFrame();            // 剩下的時間算進 DISPLAY，結算這一幀
+
+    // 面板與卡頓紀錄的開關（畫面上按 F3 / F4）
+    bool overlayVisible() const { return overlay; }
+    void setOverlayVisible(bool on) { overlay = on; }
+    bool logEnabled() const { return log; }
+    void setLogEnabled(bool on) { log = on; }
+
+    double budgetMs() const { return budget; }
+    uint64_t frameCount() const { return frames; }
+    uint64_t droppedTotal() const { return droppedFrames; }
+    Summary recent() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double budget;
+    bool overlay = false;
+    bool log = false;
+    uint64_t frames = 0;
+    uint64_t droppedFrames = 0;
+
+    Clock::time_point frameStart, mark;
+    Frame current;
+    std::vector<Frame> ring; // 最近 RECENT_FRAMES 幀
+    size_t ringNext = 0;
+
+    // CSV 的這一秒
+    FILE* csv = nullptr;
+    Clock::time_point csvStart, rowStart;
+    int rowFrames = 0, rowDropped = 0;
+    double rowTotalMs = 0, rowMaxMs = 0;
+    double rowPhaseMs[PHASE_COUNT] = {};
+    long rowDrawCalls = 0;
+    int rowHistogram[HISTOGRAM_BUCKETS] = {};
+
+    static double msSince(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+    void writeRow(Clock::time_point now);
+};
+
+#endif
@@ -5,27 +5,95 @@
 #include "Player.hpp"
 #include "AIPlayer.hpp"
 #include "HumanPlayer.hpp"
+#include "GameRecord.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
+// 非同步的對局控制：提交人類的一步後立刻返回，AI 的回應在 executor 上搜尋，
+// 完成後透過 future 與（可選的）回呼送出。呼叫端的執行緒不會停在搜尋裡，
+// 適合嵌入處理請求的服務。所有公開函式都可從任意執行緒呼叫
 class GameController {
 public:
-    GameController(bool vsAI);
-    ~GameController();
+    enum class Status {
+        Played,    // AI 已下出 move
+        Rejected,  // 人類的這一步不合法、不是人類的回合或 AI 仍在思考
+        Waiting,   // 人類已下，接著仍輪到人類（雙人對局）或對局已結束，不需要 AI 回應
+        Cancelled, // 搜尋被 cancel() 中止，棋盤沒有變動，之後可再 requestAIMove()
+        Error,     // AI 沒有下出合法的一步（無步可下或落子被拒），棋盤沒有變動，原因見 error
+    };
 
-    const Board& getBoard() const;
+    struct Reply {
+        Status status = Status::Rejected;
+        std::pair<int, int> move{-1, -1}; // AI 的落子（Played 時有效）
+        bool gameOver = false;
+        char winner = '.';
+        SearchResult search;               // 分數、節點數與耗時
+        std::string error;                 // Error 時的原因
+    };
+    using ReplyCallback = std::function<void(const Reply&)>;
+
+    // executor 為 nullptr 時自備一條工作執行緒；共用的 executor 必須比控制器活得久
+    explicit GameController(bool vsAI, ThreadPool* executor = nullptr);
+    ~GameController(); // 中止進行中的搜尋並等它結束
+    GameController(const GameController&) = delete;
+    GameController& operator=(const GameController&) = delete;
+
+    Board getBoard() const;
     char getCurrentSymbol() const;
-    bool makeMove(int row, int col);
     bool isGameOver() const;
     char getWinnerSymbol() const;
+    bool isThinking() const;
+    std::vector<std::pair<int, int>> getHistory() const; // 從開局起的每一步（黑先）
+
+    // 提交人類的一步，立即返回。輪到 AI 時開始搜尋，onReply 在 executor 的執行緒上呼叫；
+    // 當下就能決定的結果（Rejected、Waiting）則直接在呼叫端的執行緒上回呼。
+    // timeLimit 為這一步 AI 的思考時間，0 表示用 setTimeLimit 的設定
+    std::future<Reply> submitMove(int row, int col, ReplyCallback onReply = nullptr,
+                                  std::chrono::milliseconds timeLimit = std::chrono::milliseconds(0));
+    // 輪到 AI 而沒有在搜尋時（例如取消之後）重新要求它下一步
+    std::future<Reply> requestAIMove(ReplyCallback onReply = nullptr,
+                                     std::chrono::milliseconds timeLimit = std::chrono::milliseconds(0));
+    void cancel(); // 中止進行中的搜尋，回應為 Cancelled
+
+    // 同步版本：提交並等待 AI 回應（命令列等不在意阻塞的呼叫端使用，不可在 executor 上呼叫）
+    bool makeMove(int row, int col);
+
+    void setTimeLimit(std::chrono::milliseconds limit);
+    bool setRecordFile(const std::string& path); // 棋譜追加到檔案，每一步都寫出（見 GameRecordWriter）
+    bool setTableFile(const std::string& path);  // AI 的置換表存到檔案；沒有 AI 或檔案不合用時回傳 false
 
 private:
     Board board;
-    Player* p1;
-    Player* p2;
-    Player* current;
-    bool gameOver;
-    char winner;
+    std::unique_ptr<Player> players[2]; // [0] 黑 X、[1] 白 O
+    int turn = 0;
+    bool gameOver = false;
+    char winner = '.';
+    std::vector<std::pair<int, int>> history;
+    GameRecordWriter recorder;
+
+    std::unique_ptr<ThreadPool> ownExecutor;
+    ThreadPool* executor;
+    std::chrono::milliseconds timeLimit;
+    bool thinking = false;
+    std::atomic<bool> stopFlag{false};
+    mutable std::mutex mutex;
+    std::condition_variable idle; // thinking 變回 false 時通知（解構用）
 
-    void switchTurn();
+    AIPlayer* aiToMove() const; // 目前輪到的是 AI 時回傳它，否則 nullptr（不擁有）
+    bool placeLocked(int row, int col); // 落子並更新勝負、棋譜；呼叫端需持有 mutex
+    std::future<Reply> startSearchLocked(std::unique_lock<std::mutex>& lock, ReplyCallback onReply,
+                                         std::chrono::milliseconds limit);
+    Reply snapshotLocked(Status status) const;
+    void finishRecord();
 };
 
 #endif
@@ -0,0 +1,115 @@
+#ifndef GAMERECORD_HPP
+#define GAMERECORD_HPP
+
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+// --- 棋譜格式 --- //
+// 檔案 = 8 bytes 魔術字 "GMKREC1\0" + 一盤接一盤的紀錄，只會往後追加（進行中的最後一盤在原位改標頭）。
+// 每盤棋（little-endian）：
+//   u32 紀錄總長度 | u8 棋盤大小 | u8 結果 | u8 規則 | u8 旗標
+//   u16 步數 | u32 每步時間(ms) | u8 搜尋深度 | u8 黑方名稱長度 | u8 白方名稱長度
+//   名稱... | 走法...
+// 走法以格子編號 row * size + col 儲存：15x15 每步 1 byte，更大的棋盤每步 2 bytes。
+// 棋盤大小只接受 15 / 19（與 dispatchBoardSize 相同）
+
+enum class RecordResult : uint8_t { Unknown = 0, BlackWin = 1, WhiteWin = 2, Draw = 3 };
+
+struct GameRecord {
+    int boardSize = 15;
+    RecordResult result = RecordResult::Unknown;
+    uint8_t rule = 0;            // 0: freestyle, 1: standard, 2: renju（見 Rules.hpp 的 id）
+    uint32_t timePerMoveMs = 0;  // 引擎每步的時間限制，0 表示無
+    uint8_t searchDepth = 0;
+    std::string black;           // 'X'，先手
+    std::string white;           // 'O'
+    std::vector<std::pair<int, int>> moves;
+};
+
+// 追加棋譜的寫入器。對局中每下一步只在檔尾追加這一步的 1～2 bytes，再改這一盤標頭的長度與步數並 flush
+// （結果暫為 Unknown），程式當掉時檔案裡仍留著到最後一步為止的完整紀錄；
+// 沒有 endGame 就開始下一盤時，上一盤也以 Unknown 保留。open 時若檔尾有寫到一半的紀錄會先截掉。
+// 同一時間只能有一盤進行中；多盤同時進行的程式請在每盤結束時用 write 整盤寫入
+class GameRecordWriter {
+public:
+    GameRecordWriter() = default;
+    ~GameRecordWriter();
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return out != nullptr; }
+
+    void beginGame(const GameRecord& info); // 沿用 info 的標頭欄位，清空走法
+    bool addMove(int row, int col);         // 追加一步並 flush
+    bool endGame(RecordResult result);
+    bool write(const GameRecord& game);     // 整盤追加
+
+private:
+    FILE* out = nullptr;
+    GameRecord current;
+    bool inGame = false;
+    long end = 0;        // 最後一筆完整紀錄之後的位置
+    long gameStart = -1; // 進行中的這一盤在檔案中的位置，還沒寫過為 -1
+
+    bool writeAt(long pos, const GameRecord& game); // 寫入並 flush，成功時 end 移到這筆之後
+    bool patchHeader();                             // 依 current 改寫進行中這一盤的固定欄位並 flush
+};
+
+// 零複製讀取器：mmap 整個檔案，依序走訪每盤棋，不會把走法複製出來。
+// viewAt 會檢查長度、棋盤大小與每一步的格子編號，損壞或截斷的紀錄視同檔案結尾
+class GameRecordReader {
+public:
+    class GameView {
+    public:
+        int boardSize() const { return data[4]; }
+        RecordResult result() const { return static_cast<RecordResult>(data[5]); }
+        uint8_t rule() const { return data[6]; }
+        int moveCount() const { return data[8] | (data[9] << 8); }
+        uint32_t timePerMoveMs() const { return data[10] | (data[11] << 8) | (data[12] << 16) | (uint32_t(data[13]) << 24); }
+        uint8_t searchDepth() const { return data[14]; }
+        std::string black() const { return std::string(reinterpret_cast<const char*>(data + 17), data[15]); }
+        std::string white() const { return std::string(reinterpret_cast<const char*>(data + 17 + data[15]), data[16]); }
+        std::pair<int, int> move(int i) const;
+        GameRecord toRecord() const;
+
+    private:
+        friend class GameRecordReader;
+        const unsigned char* data = nullptr;
+        const unsigned char* moves = nullptr;
+    };
+
+    bool open(const std::string& path);
+    void close() { file.close(); }
+    bool isOpen() const { return file.isOpen(); }
+
+    // 從頭開始走訪；offset 為檔案位置，可用來平行切分
+    void rewind() { offset = HEADER_SIZE; }
+    bool next(GameView& game);
+    bool viewAt(size_t pos, GameView& game) const; // 不移動走訪位置，可多執行緒同時使用
+    size_t tell() const { return offset; }
+    void seek(size_t pos) { offset = pos; }
+    size_t size() const { return file.size(); }
+
+    static const size_t HEADER_SIZE = 8;
+
+private:
+    MappedFile file;
+    size_t offset = HEADER_SIZE;
+};
+
+// --- 文字格式 --- //
+// 座標記法：欄以字母 a.. 表示，列由下往上從 1 起算，例如 "h8 i9 j10"
+std::string formatMoveText(const GameRecord& game);
+bool parseMoveText(const std::string& text, int boardSize, std::vector<std::pair<int, int>>& moves);
+
+// Piskvork 的 .psq：第一行 "Piskvorky 15x15, 11:11, 0"，之後每行 "x,y,時間"（1 起算）
+std::string formatPsq(const GameRecord& game);
+bool parsePsq(const std::string& text, GameRecord& game);
+
+#endif
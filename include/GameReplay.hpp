@@ -0,0 +1,117 @@
+#ifndef GAMEREPLAY_HPP
+#define GAMEREPLAY_HPP
+
+#include "Board.hpp"
+#include "Rules.hpp"
+#include "SearchEngine.hpp"
+#include "Zobrist.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// --- 棋譜重播 --- //
+// 每 KEYFRAME_INTERVAL 手存一份盤面（關鍵盤面）。跳到第 ply 手時，從最近的關鍵盤面補上之後的幾手，
+// 或從目前位置逐手前進 / 後退，取落子次數較少的一種；再長的棋譜，一次跳轉也不超過 KEYFRAME_INTERVAL 次落子
+template <int N>
+class GameReplay {
+public:
+    using BoardType = BasicBoard<N>;
+    static const int KEYFRAME_INTERVAL = 16;
+
+    // 載入一盤棋並停在第 0 手；遇到不合法的一步就截斷在那之前並回傳 false。
+    // rule 為棋譜的規則欄位（Rules.hpp 的 id），勝負依它判定
+    bool load(const std::vector<std::pair<int, int>>& moves, uint8_t rule = ActiveRule::id);
+
+    void seek(int ply); // 超出範圍時夾到 [0, length()]
+    void step(int delta) { seek(at + delta); }
+
+    int length() const { return static_cast<int>(moves.size()); }
+    int ply() const { return at; } // 目前盤面已經下了幾手
+    const BoardType& board() const { return current; }
+    uint64_t key() const { return hash; } // 盤面的 Zobrist 雜湊；輪到誰由子數決定，不另外編入
+    char sideToMove() const { return symbolAt(at); }
+    std::pair<int, int> moveAt(int i) const { return moves[i]; } // 第 i 手（0 起算）
+    std::pair<int, int> lastMove() const { return at > 0 ? moves[at - 1] : std::make_pair(-1, -1); }
+    bool isOver() const { return winner() != '.' || current.isFull(); } // 最後一手連成五或棋盤已滿
+    char winner() const; // 最後一手連成五時為它的顏色，否則 '.'
+    uint8_t rule() const { return ruleId; }
+
+    // 不移動目前位置，算出第 ply 手的盤面與雜湊（背景分析排程用）
+    BoardType boardAt(int ply, uint64_t& key) const;
+
+    static char symbolAt(int ply) { return ply % 2 ? 'O' : 'X'; } // 第 ply 手（0 起算）的顏色
+    // 依規則 id 判斷 (row, col) 這一手是否獲勝；不認得的 id 當作自由規則
+    static bool isWin(uint8_t rule, const BoardType& board, int row, int col, char symbol);
+
+private:
+    struct Keyframe {
+        BoardType board;
+        uint64_t hash;
+    };
+
+    std::vector<std::pair<int, int>> moves;
+    std::vector<Keyframe> keyframes; // keyframes[k] 是第 k * KEYFRAME_INTERVAL 手的盤面
+    BoardType current;
+    uint64_t hash = 0;
+    int at = 0;
+    uint8_t ruleId = ActiveRule::id;
+};
+
+// --- 重播時的背景評估 --- //
+// 目前這一手優先，接著依距離往後、往前預先分析，結果依盤面雜湊快取，來回瀏覽時不必重算。
+// 使用者跳到還沒分析的局面時，正在搜尋的其他局面會被中止；仍在預先分析範圍內的話，之後會重新排到
+template <int N>
+class ReplayAnalyzer {
+public:
+    ReplayAnalyzer(int depth = 6, std::chrono::milliseconds timeLimit = std::chrono::seconds(3));
+    ~ReplayAnalyzer();
+    ReplayAnalyzer(const ReplayAnalyzer&) = delete;
+    ReplayAnalyzer& operator=(const ReplayAnalyzer&) = delete;
+
+    // 換成新的待分析清單：replay 目前這一手與前後各 prefetch 手（已快取、已分出勝負的略過）
+    void request(const GameReplay<N>& replay, int prefetch);
+
+    // 分數是當時輪到的一方的角度
+    bool lookup(uint64_t key, SearchResult& result) const;
+    size_t cachedCount() const;
+
+    static const size_t MAX_CACHED = 1 << 16; // 超過就整個清掉
+
+private:
+    struct Job {
+        uint64_t key;
+        BasicBoard<N> board;
+        char side;
+    };
+
+    int depth;
+    std::chrono::milliseconds timeLimit;
+    std::unique_ptr<SearchEngine<N>> engines[2]; // 輪到 X / O；只在工作執行緒上使用
+
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> queue;                             // 受 mutex 保護
+    std::unordered_map<uint64_t, SearchResult> cache; // 受 mutex 保護
+    bool running = false;                              // 受 mutex 保護
+    uint64_t runningKey = 0;                           // 受 mutex 保護
+    bool quit = false;                                 // 受 mutex 保護
+    std::atomic<bool> stop{false};
+
+    void loop();
+};
+
+extern template class GameReplay<15>;
+extern template class GameReplay<19>;
+extern template class ReplayAnalyzer<15>;
+extern template class ReplayAnalyzer<19>;
+
+#endif
@@ -1,8 +1,18 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include "Board.hpp"
-#include "Player.hpp"
+#include "GameController.hpp"
+#include "GameRecord.hpp"
+#include "SearchEngine.hpp"
+#include "FrameStats.hpp"
+#include "GameReplay.hpp"
+#include <atomic>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include <SFML/System.hpp>  // 引入 sf::Clock
 #include <cmath>  // 引入 <cmath> 库以使用 sin 函数
     enum class GameResult {
@@ -14,22 +24,29 @@
 
 class GameWindow {
 public:
-    GameWindow(std::unique_ptr<Player> p1, std::unique_ptr<Player> p2, bool isPvP);
-    static bool showModeSelection(sf::RenderWindow& window, sf::Font& font, bool& isPvP);
+    // isPvP 為 false 時白方（O）由 AI 下；frameStats 由呼叫端持有並跨對局沿用，nullptr 表示不計時
+    explicit GameWindow(bool isPvP, FrameStats* frameStats = nullptr);
+    ~GameWindow();
+    // isReplay 為 true 表示選了重播（此時 isPvP 無意義）
+    static bool showModeSelection(sf::RenderWindow& window, sf::Font& font, bool& isPvP, bool& isReplay);
 
     GameResult run(sf::RenderWindow& window, sf::Font& font);
+    // 重播 path 裡的棋譜（棋盤大小不同的局略過）；Esc 回到選單
+    GameResult runReplay(sf::RenderWindow& window, sf::Font& font, const std::string& path);
 
 
 private:
-    int boardSize = 15; // 15x15 棋盤
+    int boardSize = Board::SIZE; // 棋盤大小跟隨 Board（15x15）
 
     int CELL_SIZE = 600 / boardSize;  
 
     char currentPlayerSymbol = 'X'; // 初始為 Player 1（黑子）
     sf::Clock clock;
 
-    std::unique_ptr<Player> p1, p2;
-    Player* currentPlayer;
+    // 對局狀態、落子規則與棋譜都由 controller 管理，AI 在它的工作執行緒上搜尋；
+    // 下面的 board 等欄位是每次局面改變後複製過來給畫面用的
+    std::unique_ptr<GameController> controller;
+    std::future<GameController::Reply> aiReply; // AI 思考中時有效，update() 每幀檢查是否完成
     Board board;
     bool isPvP;
     bool gameOver;
@@ -47,6 +64,34 @@ private:
 
     char winner = ' '; // 'X', 'O', or ' ' for draw
 
+    // --- 分析熱度圖（按 H 切換）--- //
+    // 背景執行緒做多主要變化分析，每完成一層就更新 analysisLines；繪製時只在鎖內複製
+    static const int HEATMAP_LINES = 8;
+    bool showHeatmap = false;
+    std::unique_ptr<SearchEngine<Board::SIZE>> analysisEngines[2]; // 輪到 X / O 時各用一個
+    std::thread analysisThread;
+    std::atomic<bool> analysisStop{false};
+    std::mutex analysisMutex;
+    std::vector<SearchResult> analysisLines; // 受 analysisMutex 保護
+    int analysisDepth = -1;                  // 受 analysisMutex 保護
+
+    // --- 逐幀計時（F3 面板、F4 卡頓紀錄）--- //
+    FrameStats* frameStats;
+
+    // --- 棋譜重播（runReplay）--- //
+    // 左右鍵逐手、Home / End 跳到頭尾、拖曳進度列任意跳轉、上下鍵換局；
+    // 每一手的評估在背景計算並快取，目前這一手優先，再預先分析前後 REPLAY_PREFETCH 手。
+    // 棋譜檔不先整個走過：往後換局時才用 replayReader.next 找下一局，找過的位置記在 replayGames
+    static const int REPLAY_PREFETCH = 4;
+    GameRecordReader replayReader;
+    std::vector<size_t> replayGames; // 已經找到的每一局在檔案中的位置
+    bool replayAllFound = false;     // 檔案已經走到底，replayGames 就是全部
+    int replayGame = 0;
+    std::string replayTitle;         // 對局雙方與結果
+    GameReplay<Board::SIZE> replay;
+    std::unique_ptr<ReplayAnalyzer<Board::SIZE>> replayAnalyzer;
+    bool replayScrubbing = false;    // 正在拖曳進度列
+
     sf::RectangleShape restartButton;
     sf::RectangleShape exitButton;
     sf::RectangleShape  gameModeButton;
@@ -57,5 +102,18 @@ private:
     void handleEvents(sf::RenderWindow& window);
     void update();
     void draw(sf::RenderWindow& window,sf::Font& font);
+    void drawBoard(sf::RenderWindow& window); // 棋盤格與棋子
     void displayResult(sf::RenderWindow& window, sf::Font& font);
+    void syncFromController();
+    void startAnalysis(); // 局面改變後重新分析
+    void stopAnalysis();
+    void drawHeatmap(sf::RenderWindow& window, sf::Font& font);
+    void drawItem(sf::RenderWindow& window, const sf::Drawable& item); // window.draw 並計入 draw 呼叫數
+    void drawFrameStats(sf::RenderWindow& window, sf::Font& font);
+    void handleFrameStatsKey(const sf::Event& event);
+    bool findNextReplayGame();
+    bool loadReplayGame(int index);
+    void seekReplay(int ply);
+    void handleReplayEvents(sf::RenderWindow& window);
+    void drawReplay(sf::RenderWindow& window, sf::Font& font);
 };
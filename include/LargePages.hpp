@@ -0,0 +1,66 @@
+#ifndef LARGEPAGES_HPP
+#define LARGEPAGES_HPP
+
+#include <cstddef>
+#include <string>
+
+// 大型表格（置換表、評估快取）的配置策略，整個行程共用；應在建立引擎之前設定，
+// 之後配置（含 resize）的表格才會套用
+struct LargePagePolicy {
+    enum class Pages {
+        Normal,      // 一般 4 KB 頁面
+        Transparent, // 透明大頁 (madvise)，核心關閉時等同 Normal
+        Explicit,    // 預留的 hugetlbfs 大頁；預留不足時退回 Transparent
+    };
+    enum class Numa {
+        Local,      // 不指定，由作業系統決定（通常是第一次存取的執行緒所在節點）
+        Interleave, // 頁面輪流分散到各節點，任何執行緒存取的平均延遲相同
+        FirstTouch, // 配置時由綁在各節點上的執行緒各自清零一段，表格依節點切塊
+    };
+    Pages pages = Pages::Transparent;
+    Numa numa = Numa::Interleave;
+
+    static bool parsePages(const std::string& text, Pages& out); // off | thp | explicit
+    static bool parseNuma(const std::string& text, Numa& out);   // local | interleave | firsttouch
+};
+
+void setLargePagePolicy(const LargePagePolicy& policy);
+const LargePagePolicy& largePagePolicy();
+
+// 系統資訊：可用的 NUMA 節點與 CPU（已扣除行程的 affinity 限制）
+int numaNodeCount();
+std::string memoryTopologySummary(); // 例如 "2 NUMA nodes, 64 CPUs, THP madvise, 2048 kB huge pages (512 reserved)"
+
+// 把目前的執行緒綁到第 slot 個位置：slot 依序輪流分到各節點，節點內再依序分到各 CPU。
+// 搜尋執行緒用連續的 slot 綁定時會平均分散在所有節點上。不支援的平台回傳 false
+bool pinCurrentThread(int slot);
+
+// 依 largePagePolicy() 配置的匿名記憶體，內容保證為 0。
+// 大頁或 NUMA 設定失敗時自動退回一般配置，只有真的配置不到記憶體才回傳 false
+class LargeBuffer {
+public:
+    LargeBuffer() = default;
+    ~LargeBuffer();
+    LargeBuffer(const LargeBuffer&) = delete;
+    LargeBuffer& operator=(const LargeBuffer&) = delete;
+
+    bool allocate(size_t bytes); // 先釋放原有的配置
+    void release();
+
+    void* data() const { return base; }
+    size_t size() const { return length; }
+    // 實際採用的方式（退回後的結果），供統計輸出
+    LargePagePolicy::Pages pages() const { return usedPages; }
+    LargePagePolicy::Numa numa() const { return usedNuma; }
+    std::string describe() const; // 例如 "explicit/interleave"
+
+private:
+    void* base = nullptr;
+    size_t length = 0;
+    void* mapping = nullptr; // 對齊前的整段映射
+    size_t mappingLength = 0;
+    LargePagePolicy::Pages usedPages = LargePagePolicy::Pages::Normal;
+    LargePagePolicy::Numa usedNuma = LargePagePolicy::Numa::Local;
+};
+
+#endif
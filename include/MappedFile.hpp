@@ -0,0 +1,44 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// 唯讀或讀寫的記憶體映射檔案（POSIX mmap / Windows MapViewOfFile）
+// 開啟時不讀取內容，頁面由作業系統在第一次存取時才載入
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool openRead(const std::string& path);
+    bool openReadWrite(const std::string& path, size_t size); // 不存在時建立並調整大小
+    void flush(); // 把修改寫回磁碟
+    // 提示核心以大頁對應（Linux 的 MADV_HUGEPAGE；唯讀檔案需核心支援 READ_ONLY_THP_FOR_FS）。
+    // 只是建議，不支援時沒有任何作用
+    void adviseHugePages();
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    const unsigned char* data() const { return static_cast<const unsigned char*>(base); }
+    unsigned char* data() { return static_cast<unsigned char*>(base); }
+    size_t size() const { return length; }
+
+private:
+    void* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    bool map(bool writable);
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef MOVELIST_HPP
+#define MOVELIST_HPP
+
+#include <utility>
+
+// 固定容量的走法清單：直接放在呼叫端的堆疊上，搜尋過程中不做任何 heap 配置
+template <int Capacity>
+class FixedMoveList {
+public:
+    using value_type = std::pair<int, int>;
+
+    void push_back(const value_type& move) { moves[count++] = move; }
+    void emplace_back(int row, int col) { moves[count++] = {row, col}; }
+    void clear() { count = 0; }
+    void truncate(int n) { if (n < count) count = n; } // 只保留前 n 步
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    value_type& operator[](int i) { return moves[i]; }
+    const value_type& operator[](int i) const { return moves[i]; }
+
+    value_type* begin() { return moves; }
+    value_type* end() { return moves + count; }
+    const value_type* begin() const { return moves; }
+    const value_type* end() const { return moves + count; }
+
+private:
+    value_type moves[Capacity];
+    int count = 0;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef NNUE_HPP
+#define NNUE_HPP
+
+#include "Board.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// --- 小型 NNUE 評估網路 --- //
+// 輸入為每格 × 顏色的 one-hot（N*N*2），第一層輸出即「累加器」：
+// 落子只需加上一列權重、提子減掉一列，搜尋時沿著走法逐層更新，不必重算整盤。
+//   累加器 int16[HIDDEN] → clamp(0,127) → int8 權重 → HIDDEN2 → clamp → int8 權重 → 分數
+// 分數以 X 的角度計算，與棋型評估相同。內積在支援的 CPU 上走 AVX2，否則用純量版本
+class NnueNetwork {
+public:
+    static const int HIDDEN = 64;
+    static const int HIDDEN2 = 32;
+    static const uint32_t FILE_VERSION = 1;
+
+    struct alignas(32) Accumulator {
+        int16_t v[HIDDEN];
+    };
+
+    // 權重檔（little-endian）：
+    //   char[8] "GMKNNUE" | u32 版本 | u32 棋盤大小 | u32 HIDDEN | u32 HIDDEN2 | i32 輸出倍率 | u32 保留
+    //   i16 w1[N*N*2][HIDDEN] | i16 b1[HIDDEN] | i8 w2[HIDDEN2][HIDDEN] | i32 b2[HIDDEN2]
+    //   i8 w3[HIDDEN2] | i32 b3
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    void randomize(int boardSize, uint64_t seed); // 產生小權重的網路，測試與基準用
+
+    bool isLoaded() const { return size > 0; }
+    int boardSize() const { return size; }
+    uint64_t fingerprint() const { return checksum; } // 權重的雜湊，置換表存檔簽章用
+
+    // color: 0 = X, 1 = O
+    template <int N>
+    void refresh(const BasicBoard<N>& board, Accumulator& acc) const {
+        reset(acc);
+        for (int r = 0; r < N; ++r)
+            for (int c = 0; c < N; ++c)
+                if (int code = board.cellCode(r, c)) add(acc, r * N + c, code - 1);
+    }
+    void reset(Accumulator& acc) const;
+    void add(Accumulator& acc, int cell, int color) const;
+    void sub(Accumulator& acc, int cell, int color) const;
+    int evaluate(const Accumulator& acc) const;
+
+    // 預設依 CPU 自動選擇；關掉可強制走純量路徑（比對結果用）
+    void setSimd(bool enabled) { simd = enabled && simdSupported(); }
+    bool usesSimd() const { return simd; }
+    static bool simdSupported();
+
+private:
+    int size = 0;
+    int32_t outputScale = 1;
+    std::vector<int16_t> w1; // [cell*2 + color][HIDDEN]
+    alignas(32) int16_t b1[HIDDEN] = {};
+    alignas(32) int8_t w2[HIDDEN2][HIDDEN] = {};
+    int32_t b2[HIDDEN2] = {};
+    alignas(32) int8_t w3[HIDDEN2] = {};
+    int32_t b3 = 0;
+    uint64_t checksum = 0;
+    bool simd = false;
+
+    void updateChecksum();
+    int evaluateScalar(const Accumulator& acc) const;
+    int evaluateAvx2(const Accumulator& acc) const;
+    void addAvx2(Accumulator& acc, const int16_t* row, bool subtract) const;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef OPENINGBOOK_HPP
+#define OPENINGBOOK_HPP
+
+#include "Board.hpp"
+#include "Rules.hpp"
+#include "Zobrist.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 以 Zobrist 標準形雜湊為鍵的開局庫。
+// 檔案 = 標頭 + 依 (hash, 走法) 排序的固定長度紀錄，直接 mmap 後二分搜尋，
+// 開啟時不做任何解析，檔案再大啟動也是瞬間完成
+class OpeningBook {
+public:
+    static const uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[8];      // "GMKBOOK\0"
+        uint32_t version;
+        uint32_t boardSize;
+        uint64_t count;     // 紀錄數
+    };
+
+    // 走法以標準形座標儲存；統計以該步的落子方為準
+    struct Record {
+        uint64_t hash;
+        uint8_t row;
+        uint8_t col;
+        uint16_t weight;
+        uint32_t games;
+        uint32_t wins;
+        uint32_t draws;
+    };
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return records != nullptr; }
+    int boardSize() const { return size; }
+    uint64_t recordCount() const { return count; }
+    const Record* begin() const { return records; }
+    const Record* end() const { return records + count; }
+
+    // 同一局面的所有候選走法 [first, second)
+    std::pair<const Record*, const Record*> find(uint64_t hash) const;
+
+    // 查出目前局面權重最高、而且在這個盤面上能下的走法，已換回實際棋盤座標。
+    // 權重為 0 的紀錄（一場都沒拿到分）不採用；格子已被佔（雜湊碰撞）或 Rule 判為禁手的也跳過
+    template <class Rule = ActiveRule, int N>
+    std::optional<std::pair<int, int>> probe(const BasicBoard<N>& board, char symbol, uint32_t minGames = 1) const {
+        if (!isOpen() || size != N) return std::nullopt;
+        int sym;
+        uint64_t key = hashPosition(board).canonical(sym);
+        auto [first, last] = find(key);
+        std::optional<std::pair<int, int>> best;
+        uint16_t bestWeight = 0;
+        for (const Record* r = first; r != last; ++r) {
+            if (r->games < minGames || r->weight == 0 || r->weight <= bestWeight) continue;
+            auto move = applySymmetry<N>(inverseSymmetry(sym), r->row, r->col);
+            if (r->row >= N || r->col >= N || board.getCell(move.first, move.second) != '.') continue;
+            if (Rule::isForbidden(board, move.first, move.second, symbol)) continue;
+            best = move;
+            bestWeight = r->weight;
+        }
+        return best;
+    }
+
+    // 排序、合併相同 (hash, 走法) 的紀錄並寫出檔案
+    static bool write(const std::string& path, int boardSize, std::vector<Record> records);
+    static uint16_t computeWeight(const Record& r);
+
+private:
+    MappedFile file;
+    const Record* records = nullptr;
+    uint64_t count = 0;
+    int size = 0;
+};
+
+static_assert(sizeof(OpeningBook::Header) == 24, "開局庫標頭大小固定");
+static_assert(sizeof(OpeningBook::Record) == 24, "開局庫紀錄大小固定");
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef PATTERNTABLE_HPP
+#define PATTERNTABLE_HPP
+
+#include <cstdint>
+#include <string>
+
+// 評估權重：依窗口內同色子數（1..5）與兩端狀態（兩端空 / 一端擋 / 兩端擋）共 15 個值。
+// 評估對權重是線性的，調整工具 (eval_tuner) 直接擬合這 15 個數
+struct EvalWeights {
+    enum Ends { OPEN = 0, HALF = 1, CLOSED = 2 };
+    static const int COUNT = 15;
+
+    int value[COUNT];
+
+    EvalWeights(); // 手調的預設值
+
+    static int slot(int stones, int ends) { return (stones - 1) * 3 + ends; }
+    int& at(int stones, int ends) { return value[slot(stones, ends)]; }
+    int at(int stones, int ends) const { return value[slot(stones, ends)]; }
+    static std::string name(int slot); // 參數檔中的鍵，例如 "four.half"
+
+    // 參數檔：每行 "鍵 值"，# 開頭為註解；沒出現的鍵保留原值
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+};
+
+// 棋型分數表：預先算好每種「五格 + 左右兩端」組合的分數（X 的分數減 O 的分數），
+// 評估時每個窗口只需查一次表。密集與稀疏兩種引擎共用。
+class PatternTable {
+public:
+    static const int WINDOWS = 243; // 3^5
+    static const int COUNT = 4 * WINDOWS;
+
+    explicit PatternTable(const EvalWeights& weights = EvalWeights());
+
+    // 索引 = 左側是否為空 + 2 * 右側是否為空 + 4 * (五格的三進位編碼，0: 空, 1: X, 2: O)
+    static int index(int window, bool leftOpen, bool rightOpen) {
+        return window * 4 + (leftOpen ? 1 : 0) + (rightOpen ? 2 : 0);
+    }
+    static int window(const uint8_t* cells) {
+        return cells[0] + 3 * cells[1] + 9 * cells[2] + 27 * cells[3] + 81 * cells[4];
+    }
+
+    // 索引對應的權重位置與正負號（X 為 +1、O 為 -1）；混色或全空的窗口回傳 -1
+    static int weightSlot(int idx, int& side);
+
+    int operator[](int idx) const { return score[idx]; }
+
+    // 整條線的分數，長度為 n 的線以外視為阻擋
+    int evaluateLine(const uint8_t* line, int n) const {
+        int total = 0;
+        for (int i = 0; i <= n - 5; ++i) {
+            bool leftOpen = (i > 0 && line[i - 1] == 0);
+            bool rightOpen = (i + 5 < n && line[i + 5] == 0);
+            total += score[index(window(line + i), leftOpen, rightOpen)];
+        }
+        return total;
+    }
+
+private:
+    int score[COUNT];
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef POSITIONINDEX_HPP
+#define POSITIONINDEX_HPP
+
+#include "Board.hpp"
+#include "Zobrist.hpp"
+#include "GameRecord.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 棋譜資料庫的局面索引：把每盤棋每一步之前的局面以標準形雜湊記下，
+// 排序後寫成可 mmap 的檔案，查詢任何對稱形式的局面都是一次二分搜尋。
+// 檔案 = 標頭 | Entry[entryCount]（依 hash 排序）| u64 棋譜位移[gameCount] | u8 結果[gameCount]
+class PositionIndex {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint16_t NO_MOVE = 0xFFFF;
+
+    struct Header {
+        char magic[8];        // "GMKIDX\0\0"
+        uint32_t version;
+        uint32_t boardSize;
+        uint64_t entryCount;
+        uint64_t gameCount;
+    };
+
+    struct Entry {
+        uint64_t hash;
+        uint32_t game;      // 棋譜檔中的第幾盤
+        uint16_t ply;       // 此局面出現在第幾步之前
+        uint16_t next;      // 下一步（標準形座標的格子編號），終局為 NO_MOVE
+    };
+
+    struct MoveStat {
+        int row;
+        int col;
+        uint32_t games = 0;
+        uint32_t blackWins = 0;
+        uint32_t whiteWins = 0;
+        uint32_t draws = 0;
+    };
+
+    struct Summary {
+        uint32_t games = 0;
+        uint32_t blackWins = 0;
+        uint32_t whiteWins = 0;
+        uint32_t draws = 0;
+        std::vector<MoveStat> nextMoves;                 // 已換回查詢局面的座標，依出現次數排序
+        std::vector<std::pair<uint32_t, uint16_t>> hits; // (game, ply)
+    };
+
+    // 平行重播 recordsPath 的所有棋局並寫出索引，threads <= 0 表示使用所有核心。
+    // 外部排序：各執行緒的緩衝合計約 memoryMB，滿了就排序寫成暫存檔（indexPath.runK），
+    // 最後一次 k 路合併寫進索引，記憶體用量不隨棋譜數量成長
+    static bool build(const std::string& recordsPath, const std::string& indexPath, int boardSize,
+                      int threads = 0, size_t memoryMB = 256, uint64_t* entriesOut = nullptr);
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return entries != nullptr; }
+    int boardSize() const { return size; }
+    uint64_t entryCount() const { return count; }
+    uint64_t gameCount() const { return games; }
+    uint64_t gameOffset(uint32_t game) const { return offsets[game]; } // 可交給 GameRecordReader::seek
+
+    std::pair<const Entry*, const Entry*> find(uint64_t hash) const;
+
+    template <int N>
+    Summary query(const BasicBoard<N>& board, size_t maxHits = 100) const {
+        int sym;
+        uint64_t key = hashPosition(board).canonical(sym);
+        return summarize(find(key), inverseSymmetry(sym), maxHits);
+    }
+
+private:
+    MappedFile file;
+    const Entry* entries = nullptr;
+    const uint64_t* offsets = nullptr;
+    const uint8_t* results = nullptr;
+    uint64_t count = 0;
+    uint64_t games = 0;
+    int size = 0;
+
+    Summary summarize(std::pair<const Entry*, const Entry*> range, int toQuery, size_t maxHits) const;
+};
+
+static_assert(sizeof(PositionIndex::Header) == 32, "索引標頭大小固定");
+static_assert(sizeof(PositionIndex::Entry) == 16, "索引紀錄大小固定");
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef POTENTIALMAP_HPP
+#define POTENTIALMAP_HPP
+
+#include "Board.hpp"
+#include <cstdint>
+
+// --- 每格潛力圖 --- //
+// 對每個空格、每個方向記錄雙方「在這裡落子」的潛力：經過該格、不含對方棋子的五格窗口，
+// 依窗口內已有的己方子數加權（分數表見 src/PotentialMap.cpp）。
+// 一手棋只會改變同一條線上前後 4 格在該方向的分數，落子或提子後呼叫 update 即可，不必重掃整盤。
+// 搜尋用它排序走法並只保留前幾名（SearchEngine::setMoveWidths）
+template <int N>
+class PotentialMap {
+public:
+    static const int CELLS = N * N;
+
+    void refresh(const BasicBoard<N>& board);
+    void update(const BasicBoard<N>& board, int row, int col); // (row, col) 落子或提子之後呼叫
+
+    // 一次掃過整盤：out[cell] = 2 * mover 的進攻潛力 + 對手的潛力（防守），有子的格子為 0。
+    // mover 同 cellCode（1 = X, 2 = O）；陣列連續、長度固定，編譯器可直接向量化
+    void combine(int mover, int32_t* out) const;
+    // 雙方所有空格、所有方向中最大的單方向潛力；400 約為能成四，800 約為能成活四，20000 以上即能成五
+    int32_t maxDirectional() const;
+
+private:
+    alignas(32) int32_t dir[2][4][CELLS]; // [X / O][方向][格]
+
+    void updateCell(const BasicBoard<N>& board, int row, int col, int d);
+};
+
+extern template class PotentialMap<15>;
+extern template class PotentialMap<19>;
+
+#endif
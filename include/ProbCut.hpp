@@ -0,0 +1,32 @@
+#ifndef PROBCUT_HPP
+#define PROBCUT_HPP
+
+#include <cstdint>
+#include <string>
+
+// ProbCut 參數：剩餘深度 depth 的結果以深度 shallow 的搜尋預測，deep ≈ a * shallow + b，殘差標準差 sigma。
+// 預測值超出 alpha-beta 窗口 threshold 個 sigma 以上就不做深層搜尋，直接回傳窗口邊界。
+// 迴歸係數由 probcut_fit 以自我對局的局面離線擬合
+struct ProbCutParams {
+    struct Pair {
+        int shallow = 0; // 0 表示這個深度不剪枝
+        double a = 1.0;
+        double b = 0.0;
+        double sigma = 0.0;
+    };
+    static const int MAX_DEPTH = 32;
+
+    Pair pairs[MAX_DEPTH + 1];
+    double threshold = 1.5;     // 需要幾個 sigma 的把握
+    int32_t quietLimit = 800;   // 任一方有單一方向潛力達到這個值的點（預設約為能做出活四或五）就不剪，強制變化照常搜完
+
+    bool enabled() const;
+    const Pair* at(int depth) const { return depth <= MAX_DEPTH && pairs[depth].shallow > 0 ? &pairs[depth] : nullptr; }
+
+    // 參數檔：每行 "threshold t"、"quiet_limit n" 或 "depth d shallow a b sigma"，# 開頭為註解
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    uint64_t fingerprint() const; // 存檔置換表的 signature 用；未啟用時為 0
+};
+
+#endif
@@ -0,0 +1,343 @@
+#ifndef REFERENCEKERNELS_HPP
+#define REFERENCEKERNELS_HPP
+
+#include "Board.hpp"
+#include "PatternTable.hpp"
+#include "Rules.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// --- 參考實作（差分測試的基準） --- //
+// 搜尋引擎裡的版本改寫成 bitboard、SIMD 或增量更新時，kernel_fuzz 逐一拿來和這裡比對，
+// 因此這裡的行為就是規格；除非規則本身改變，不要為了速度修改。
+// 原始版本（8f086dd）就有的核心直接搬原本的程式：Board::isWin、AIPlayer 的 evaluateBoard / evaluateLine、
+// generateMoves、findWinningMoveIfAvailable、findBlockingMoveIfThreat。只把 Board 換成 BasicBoard<N>、
+// evaluateLine 的寫死分數換成 EvalWeights（預設值與原本的分數相同），並加上規則與禁手的判斷。
+// 原始版本沒有的（三種規則的勝負、連珠禁手、對稱雜湊）是只透過 getCell 的直接寫法
+struct ReferenceKernels {
+    static constexpr int DIRS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    template <int N>
+    static bool inside(int r, int c) {
+        return r >= 0 && r < N && c >= 0 && c < N;
+    }
+
+    // 經過 (row, col) 在 d 方向上的同色連續子數（含自己）
+    template <int N>
+    static int run(const BasicBoard<N>& board, int row, int col, int d, char symbol) {
+        int count = 1;
+        for (int s = -1; s <= 1; s += 2) {
+            int r = row + DIRS[d][0] * s, c = col + DIRS[d][1] * s;
+            while (inside<N>(r, c) && board.getCell(r, c) == symbol) {
+                count++;
+                r += DIRS[d][0] * s;
+                c += DIRS[d][1] * s;
+            }
+        }
+        return count;
+    }
+
+    // 五連以上（原本的 Board::isWin）
+    template <int N>
+    static bool isWin(const BasicBoard<N>& board, int row, int col, char symbol) {
+        const int SIZE = N;
+        int dirs[4][2] = {{0,1},{1,0},{1,1},{1,-1}};
+        for (auto& dir : dirs) {
+            int dr = dir[0], dc = dir[1];
+            int count = 1;
+            for (int i = 1; i < 5; ++i) {
+                int r = row + dr*i, c = col + dc*i;
+                if (r < 0 || r >= SIZE || c < 0 || c >= SIZE || board.getCell(r, c) != symbol) break;
+                count++;
+            }
+            for (int i = 1; i < 5; ++i) {
+                int r = row - dr*i, c = col - dc*i;
+                if (r < 0 || r >= SIZE || c < 0 || c >= SIZE || board.getCell(r, c) != symbol) break;
+                count++;
+            }
+            if (count >= 5) return true;
+        }
+        return false;
+    }
+
+    template <int N>
+    static bool hasExactFive(const BasicBoard<N>& board, int row, int col, char symbol) {
+        for (int d = 0; d < 4; ++d)
+            if (run(board, row, col, d, symbol) == 5) return true;
+        return false;
+    }
+
+    // 依規則集的勝負判定（落子後呼叫）
+    template <int N, class Rule>
+    static bool ruleWin(const BasicBoard<N>& board, int row, int col, char symbol) {
+        if (Rule::id == FreestyleRule::id) return isWin(board, row, col, symbol);
+        if (Rule::id == RenjuRule::id && symbol == 'O') return isWin(board, row, col, symbol);
+        return hasExactFive(board, row, col, symbol);
+    }
+
+    // 連珠黑棋禁手：在棋盤副本上試下，逐方向數四與活三（成五優先）
+    template <int N>
+    static bool isForbidden(const BasicBoard<N>& board, int row, int col, char symbol) {
+        if (symbol != 'X' || board.getCell(row, col) != '.') return false;
+        BasicBoard<N> b = board;
+        b.placePiece(row, col, 'X');
+        if (hasExactFive(b, row, col, 'X')) return false;
+
+        int fours = 0, threes = 0;
+        bool overline = false;
+        for (int d = 0; d < 4; ++d) {
+            overline |= run(b, row, col, d, 'X') > 5;
+            int n = fourPoints(b, row, col, d, nullptr);
+            if (n > 0) {
+                fours += isStraightFour(b, row, col, d) ? 1 : std::min(n, 2);
+            } else if (makesThree(b, row, col, d)) {
+                threes++;
+            }
+        }
+        return overline || fours >= 2 || threes >= 2;
+    }
+
+    // X 角度的靜態評估（原本 AIPlayer('X') 的 evaluateBoard）：把每條橫、直、斜線抄成 vector，
+    // 雙方各自計分後相減
+    template <int N>
+    static int evaluate(const BasicBoard<N>& board, const EvalWeights& weights) {
+        const int SIZE = N;
+        const char symbol = 'X', opponentSymbol = 'O';
+        int score = 0;
+
+        // 橫列
+        for (int i = 0; i < SIZE; ++i) {
+            std::vector<char> row;
+            for (int j = 0; j < SIZE; ++j) row.push_back(board.getCell(i, j));
+            score += evaluateLine(row, symbol, weights);
+            score -= evaluateLine(row, opponentSymbol, weights); // 加入防守視角
+        }
+
+        // 直行
+        for (int j = 0; j < SIZE; ++j) {
+            std::vector<char> col;
+            for (int i = 0; i < SIZE; ++i) col.push_back(board.getCell(i, j));
+            score += evaluateLine(col, symbol, weights);
+            score -= evaluateLine(col, opponentSymbol, weights);
+        }
+
+        // 對角線
+        for (int k = 0; k <= 2 * (SIZE - 1); ++k) {
+            std::vector<char> diag1, diag2;
+            for (int i = 0; i < SIZE; ++i) {
+                int j1 = k - i;
+                int j2 = i - (k - SIZE + 1);
+                if (j1 >= 0 && j1 < SIZE) diag1.push_back(board.getCell(i, j1));
+                if (j2 >= 0 && j2 < SIZE) diag2.push_back(board.getCell(i, j2));
+            }
+            score += evaluateLine(diag1, symbol, weights);
+            score -= evaluateLine(diag1, opponentSymbol, weights);
+            score += evaluateLine(diag2, symbol, weights);
+            score -= evaluateLine(diag2, opponentSymbol, weights);
+        }
+
+        return score;
+    }
+
+    // 8 種對稱的雜湊：直接把每顆子換算到對稱後的座標再查 Zobrist 表
+    template <int N>
+    static SymmetricHash<N> hash(const BasicBoard<N>& board) {
+        SymmetricHash<N> h;
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) {
+                char cell = board.getCell(r, c);
+                if (cell == '.') continue;
+                for (int k = 0; k < 8; ++k) {
+                    auto [tr, tc] = applySymmetry<N>(k, r, c);
+                    h.h[k] ^= zobristKeys<N>.key[tr][tc][cell == 'X' ? 0 : 1];
+                }
+            }
+        }
+        return h;
+    }
+
+    // 與任一棋子相鄰（含斜向）的空格，依列、行順序（原本的 generateMoves），再濾掉 mover 的禁手
+    template <int N, class Rule>
+    static std::vector<std::pair<int, int>> candidateMoves(const BasicBoard<N>& board, char mover) {
+        const int SIZE = N;
+        std::vector<std::pair<int, int>> moves;
+
+        const int range = 1;
+
+        for (int i = 0; i < SIZE; ++i) {
+            for (int j = 0; j < SIZE; ++j) {
+                if (board.getCell(i, j) != '.') continue;
+
+                for (int dx = -range; dx <= range; ++dx) {
+                    for (int dy = -range; dy <= range; ++dy) {
+                        int ni = i + dx, nj = j + dy;
+                        if (ni >= 0 && ni < SIZE && nj >= 0 && nj < SIZE &&
+                            board.getCell(ni, nj) != '.') {
+                            moves.emplace_back(i, j);
+                            goto next;
+                        }
+                    }
+                }
+            next:;
+            }
+        }
+
+        if (Rule::hasForbidden)
+            moves.erase(std::remove_if(moves.begin(), moves.end(),
+                                       [&](auto m) { return isForbidden(board, m.first, m.second, mover); }),
+                        moves.end());
+        return moves;
+    }
+
+    // symbol 下一手就能獲勝的點（原本的 findWinningMoveIfAvailable：依 generateMoves 的順序試下），
+    // 勝負依 Rule 判定，禁手點略過
+    template <int N, class Rule>
+    static std::optional<std::pair<int, int>> winningMove(const BasicBoard<N>& board, char symbol) {
+        auto moves = candidateMoves<N, FreestyleRule>(board, symbol);
+
+        for (auto& move : moves) {
+            auto [r, c] = move;
+            BasicBoard<N> copy = board;
+            copy.placePiece(r, c, symbol);  // 嘗試這步驟
+
+            if (!ruleWin<N, Rule>(copy, r, c, symbol)) continue;
+            if (Rule::hasForbidden && isForbidden(board, r, c, symbol)) continue;
+            return move;  // 如果這步驟可以獲勝，返回
+        }
+
+        return std::nullopt;
+    }
+
+    // 擋對手的點（原本的 findBlockingMoveIfThreat）：先找「5 格中 4 顆對方子 + 1 空」，再找「4 格中 3 顆 + 1 空」，
+    // 依起點的列、行與方向 →、↓、↘、↙ 的順序取第一個；空點是 symbol 的禁手時略過
+    template <int N, class Rule>
+    static std::optional<std::pair<int, int>> blockingMove(const BasicBoard<N>& board, char symbol) {
+        const int SIZE = N;
+        const char opponentSymbol = symbol == 'X' ? 'O' : 'X';
+        auto checkLine = [&](int startR, int startC, int dr, int dc, int length) -> std::optional<std::pair<int, int>> {
+            int count = 0;
+            std::pair<int, int> emptySpot = {-1, -1};
+
+            for (int i = 0; i < length; ++i) {
+                int r = startR + i * dr;
+                int c = startC + i * dc;
+                if (r < 0 || r >= SIZE || c < 0 || c >= SIZE)
+                    return std::nullopt;
+
+                char cell = board.getCell(r, c);
+                if (cell == opponentSymbol) {
+                    count++;
+                } else if (cell == '.') {
+                    if (emptySpot.first == -1)
+                        emptySpot = {r, c};
+                    else
+                        return std::nullopt; // 多於一個空格，不算連線威脅
+                } else {
+                    return std::nullopt;
+                }
+            }
+
+            if ((length == 5 && count == 4) || (length == 4 && count == 3)) {
+                if (Rule::hasForbidden && isForbidden(board, emptySpot.first, emptySpot.second, symbol)) return std::nullopt;
+                return emptySpot;
+            }
+
+            return std::nullopt;
+        };
+
+        // 優先檢查 4 連（5 格中有一空）=> 急需阻止
+        for (int r = 0; r < SIZE; ++r) {
+            for (int c = 0; c < SIZE; ++c) {
+                for (auto [dr, dc] : std::vector<std::pair<int, int>>{{0,1}, {1,0}, {1,1}, {1,-1}}) {
+                    auto move = checkLine(r, c, dr, dc, 5);
+                    if (move) return move;
+                }
+            }
+        }
+
+        // 若無，再檢查 3 連（4 格中有一空）=> 提前防守
+        for (int r = 0; r < SIZE; ++r) {
+            for (int c = 0; c < SIZE; ++c) {
+                for (auto [dr, dc] : std::vector<std::pair<int, int>>{{0,1}, {1,0}, {1,1}, {1,-1}}) {
+                    auto move = checkLine(r, c, dr, dc, 4);
+                    if (move) return move;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+private:
+    // 原本的 evaluateLine：每個只含 currentSymbol 的五格窗口，依子數與兩端是否被擋（線外算擋）計分
+    static int evaluateLine(const std::vector<char>& line, char currentSymbol, const EvalWeights& weights) {
+        int score = 0;
+        const int n = line.size();
+
+        for (int i = 0; i <= n - 5; ++i) {
+            int count = 0;
+            bool blockedLeft = false, blockedRight = false;
+
+            for (int j = 0; j < 5; ++j) {
+                if (line[i + j] == currentSymbol) count++;
+                else if (line[i + j] != '.') {
+                    count = -1;
+                    break;
+                }
+            }
+
+            if (count > 0) {
+                if (i == 0 || line[i - 1] != '.') blockedLeft = true;
+                if (i + 5 >= n || line[i + 5] != '.') blockedRight = true;
+
+                int ends = (blockedLeft && blockedRight) ? EvalWeights::CLOSED
+                                                         : ((blockedLeft || blockedRight) ? EvalWeights::HALF : EvalWeights::OPEN);
+                score += weights.at(count, ends);
+            }
+        }
+        return score;
+    }
+
+    // d 方向上前後 4 格內，補一子就讓 (row, col) 恰好五連的空點；points 依序記下離中心的位移
+    template <int N>
+    static int fourPoints(BasicBoard<N>& b, int row, int col, int d, int* points) {
+        int n = 0;
+        for (int i = -4; i <= 4; ++i) {
+            int r = row + DIRS[d][0] * i, c = col + DIRS[d][1] * i;
+            if (i == 0 || !inside<N>(r, c) || b.getCell(r, c) != '.') continue;
+            b.placePiece(r, c, 'X');
+            if (run(b, row, col, d, 'X') == 5) {
+                if (points) points[n] = i;
+                n++;
+            }
+            b.removePiece(r, c);
+        }
+        return n;
+    }
+
+    // 活四：兩個成五點剛好在同一條連四的兩端
+    template <int N>
+    static bool isStraightFour(BasicBoard<N>& b, int row, int col, int d) {
+        int points[9];
+        return fourPoints(b, row, col, d, points) == 2 && points[1] - points[0] == 5;
+    }
+
+    // 活三：d 方向上再補一子（不成五）就能形成經過 (row, col) 的活四
+    template <int N>
+    static bool makesThree(BasicBoard<N>& b, int row, int col, int d) {
+        for (int i = -4; i <= 4; ++i) {
+            int r = row + DIRS[d][0] * i, c = col + DIRS[d][1] * i;
+            if (i == 0 || !inside<N>(r, c) || b.getCell(r, c) != '.') continue;
+            b.placePiece(r, c, 'X');
+            bool straight = run(b, row, col, d, 'X') < 5 && isStraightFour(b, row, col, d);
+            b.removePiece(r, c);
+            if (straight) return true;
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef RULES_HPP
+#define RULES_HPP
+
+#include "Board.hpp"
+#include "SparseBoard.hpp"
+#include <cstdint>
+
+// --- 單線棋型表 --- //
+// 以落子點為中心、單一方向前後各 5 格共 10 個鄰格，每格以三進位編碼
+// （0 空、1 己方、2 擋住：對方或邊界），查表即得到「落子後」這條線上的棋型。
+// 禁手判斷只需 4 次查表，不必遞迴重掃棋盤。
+// 表以「恰好五連」計算，供連珠的黑棋使用；雙三不檢查成四點本身是否為禁手（不做遞迴）
+class LinePatterns {
+public:
+    enum : uint8_t { FIVE = 1, OVERLINE = 2, THREE = 4 }; // 第 3、4 bit 為四的數量（0..2）
+    static const int CODES = 59049;                       // 3^10
+    static constexpr int DIRS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    static uint8_t lookup(int code) { return table()[code]; }
+    static int fours(uint8_t pattern) { return pattern >> 3; }
+
+    // 以下都接受 BasicBoard<N> 與 SparseBoard；cellCode 同棋盤：0 空、1 X、2 O、3 棋盤外
+    template <int N>
+    static int codeAt(const BasicBoard<N>& board, int r, int c) {
+        return (r < 0 || r >= N || c < 0 || c >= N) ? 3 : board.cellCode(r, c);
+    }
+    static int codeAt(const SparseBoard& board, int r, int c) { return board.cellCode(r, c); }
+
+    template <class B>
+    static int encode(const B& board, int row, int col, int dr, int dc, int ownCode) {
+        int code = 0, mul = 1;
+        for (int i = -5; i <= 5; ++i) {
+            if (i == 0) continue;
+            int v = codeAt(board, row + dr * i, col + dc * i);
+            code += (v == 0 ? 0 : (v == ownCode ? 1 : 2)) * mul;
+            mul *= 3;
+        }
+        return code;
+    }
+
+    // 經過 (row, col) 在 (dr, dc) 方向上的連續同色子數（含自己）
+    template <class B>
+    static int runLength(const B& board, int row, int col, int dr, int dc, char symbol) {
+        const int own = symbol == 'X' ? 1 : 2;
+        int count = 1;
+        for (int s = -1; s <= 1; s += 2) {
+            for (int i = 1;; ++i) {
+                if (codeAt(board, row + dr * i * s, col + dc * i * s) != own) break;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    template <class B>
+    static bool hasExactFive(const B& board, int row, int col, char symbol) {
+        for (auto& d : DIRS)
+            if (runLength(board, row, col, d[0], d[1], symbol) == 5) return true;
+        return false;
+    }
+
+private:
+    static const uint8_t* table(); // 第一次使用時建立（src/Rules.cpp）
+};
+
+// --- 增量維護的單線編碼 --- //
+// 每格、每方向存 LinePatterns::encode(board, row, col, dr, dc, 1) 的值（黑棋角度），方向順序同 LinePatterns::DIRS。
+// 一格改變只會讓同一條線上前後 5 格的編碼各差一位，update 直接加減該位，不必重掃；
+// 搜尋中的禁手判斷因此只剩 4 次讀取與查表
+template <int N>
+class LineCodes {
+public:
+    static const int CELLS = N * N;
+
+    void refresh(const BasicBoard<N>& board);
+    void update(const BasicBoard<N>& board, int row, int col); // (row, col) 落子或提子之後呼叫
+
+    int code(int d, int row, int col) const { return codes[d][row * N + col]; }
+
+private:
+    uint16_t codes[4][CELLS];
+    uint8_t digits[CELLS]; // 上次更新時每格的位值（0 空、1 X、2 O），update 以此算出差值
+};
+
+extern template class LineCodes<15>;
+extern template class LineCodes<19>;
+
+// --- 規則集 --- //
+// 以型別傳入搜尋引擎，於編譯期決定勝負判定與禁手（BasicBoard 與 SparseBoard 皆可）：
+//   isWin       落子後呼叫
+//   isForbidden 落子前呼叫，true 表示這一步不合法；搜尋中改用 LineCodes 的版本，結果相同
+//   hasForbidden 為 false 時引擎略過禁手過濾
+
+// 五連以上（含長連）即獲勝
+struct FreestyleRule {
+    static constexpr const char* name = "freestyle";
+    static constexpr uint8_t id = 0; // 棋譜中的規則欄位
+    static constexpr bool hasForbidden = false;
+
+    template <class B>
+    static bool isWin(const B& board, int row, int col, char symbol) {
+        return board.isWin(row, col, symbol);
+    }
+    template <class B>
+    static bool isForbidden(const B&, int, int, char) { return false; }
+    template <int N>
+    static bool isForbidden(const LineCodes<N>&, int, int, char) { return false; }
+};
+
+// 恰好五連才獲勝，雙方長連都不算
+struct StandardRule {
+    static constexpr const char* name = "standard";
+    static constexpr uint8_t id = 1;
+    static constexpr bool hasForbidden = false;
+
+    template <class B>
+    static bool isWin(const B& board, int row, int col, char symbol) {
+        return LinePatterns::hasExactFive(board, row, col, symbol);
+    }
+    template <class B>
+    static bool isForbidden(const B&, int, int, char) { return false; }
+    template <int N>
+    static bool isForbidden(const LineCodes<N>&, int, int, char) { return false; }
+};
+
+// 連珠：黑棋（X）恰好五連才獲勝，且禁止長連、雙四、雙三；白棋五連以上即獲勝
+// 黑棋同時成五與禁手時以成五優先
+struct RenjuRule {
+    static constexpr const char* name = "renju";
+    static constexpr uint8_t id = 2;
+    static constexpr bool hasForbidden = true;
+
+    template <class B>
+    static bool isWin(const B& board, int row, int col, char symbol) {
+        if (symbol == 'X') return LinePatterns::hasExactFive(board, row, col, symbol);
+        return board.isWin(row, col, symbol);
+    }
+
+    template <class B>
+    static bool isForbidden(const B& board, int row, int col, char symbol) {
+        if (symbol != 'X') return false;
+        int codes[4];
+        for (int d = 0; d < 4; ++d)
+            codes[d] = LinePatterns::encode(board, row, col, LinePatterns::DIRS[d][0], LinePatterns::DIRS[d][1], 1);
+        return forbiddenByCodes(codes);
+    }
+    template <int N>
+    static bool isForbidden(const LineCodes<N>& lines, int row, int col, char symbol) {
+        if (symbol != 'X') return false;
+        int codes[4];
+        for (int d = 0; d < 4; ++d) codes[d] = lines.code(d, row, col);
+        return forbiddenByCodes(codes);
+    }
+
+    // 四個方向的單線編碼 → 是否禁手
+    static bool forbiddenByCodes(const int* codes) {
+        int fours = 0, threes = 0;
+        bool overline = false;
+        for (int d = 0; d < 4; ++d) {
+            uint8_t p = LinePatterns::lookup(codes[d]);
+            if (p & LinePatterns::FIVE) return false;
+            overline |= (p & LinePatterns::OVERLINE) != 0;
+            fours += LinePatterns::fours(p);
+            threes += (p & LinePatterns::THREE) ? 1 : 0;
+        }
+        return overline || fours >= 2 || threes >= 2;
+    }
+};
+
+// 圖形介面、AIPlayer 與命令列工具使用的規則，由建置選項 GOMOKU_RULE 決定
+#if defined(GOMOKU_RULE_RENJU)
+using ActiveRule = RenjuRule;
+#elif defined(GOMOKU_RULE_STANDARD)
+using ActiveRule = StandardRule;
+#else
+using ActiveRule = FreestyleRule;
+#endif
+
+#endif
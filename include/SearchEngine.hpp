@@ -0,0 +1,170 @@
+#ifndef SEARCHENGINE_HPP
+#define SEARCHENGINE_HPP
+
+#include "Board.hpp"
+#include "Rules.hpp"
+#include "Zobrist.hpp"
+#include "MoveList.hpp"
+#include "PatternTable.hpp"
+#include "Nnue.hpp"
+#include "PotentialMap.hpp"
+#include "ProbCut.hpp"
+#include "TranspositionTable.hpp"
+#include "EvalCache.hpp"
+#include "OpeningBook.hpp"
+#include "SearchTrace.hpp"
+#include <utility>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 一次搜尋的結果與統計
+struct SearchResult {
+    std::pair<int, int> move{-1, -1};
+    int score = 0;                          // 引擎自己的角度
+    uint64_t nodes = 0;
+    long long elapsedMs = 0;
+    uint64_t evalProbes = 0;                // 葉節點評估次數（含快取命中）
+    uint64_t evalHits = 0;                  // 其中由評估快取直接取得的次數
+    uint64_t probCuts = 0;                  // ProbCut 剪掉的節點數
+    uint64_t ttHits = 0;                    // 置換表查到的節點數（含接回存檔裡的）
+    std::vector<std::pair<int, int>> pv;    // 主要變化，第一步即 move
+    const char* source = "search";          // "book" / "win" / "block" / "search"；"none" 為無步可下，move 是 {-1, -1}
+};
+
+// 搜尋引擎本體：棋盤大小與規則集都是模板參數，
+// 內層迴圈的邊界全是編譯期常數，15x15 與 19x19 各自產生一份程式碼
+template <int N, class Rule = ActiveRule>
+class SearchEngine {
+public:
+    using BoardType = BasicBoard<N>;
+    using MoveList = FixedMoveList<N * N>;
+    static const int SIZE = N;
+
+    SearchEngine(char symbol, size_t ttSizeMB = 16);
+
+    // 清空置換表並在時間限制內找出最佳步
+    std::pair<int, int> search(BoardType& board);
+    SearchResult analyze(BoardType& board); // 同 search，另外回報分數、主要變化與節點數
+
+    // 多主要變化分析：回傳分數最高的 k 步（由高到低），每完成一層深度就呼叫 onUpdate。
+    // onUpdate 在搜尋執行緒上執行，應盡快返回
+    using MultiPVCallback = std::function<void(const std::vector<SearchResult>& lines, int depth)>;
+    std::vector<SearchResult> analyzeMultiPV(BoardType& board, int k, const MultiPVCallback& onUpdate = nullptr);
+
+    std::optional<std::pair<int, int>> findBlockingMoveIfThreat(BoardType& board);
+    std::optional<std::pair<int, int>> findWinningMoveIfAvailable(BoardType& board);
+    // 個別核心的入口，差分測試 (kernel_fuzz) 拿來和 ReferenceKernels 比對
+    int evaluate(BoardType& board) { return evaluateBoard(board); }
+    void candidateMoves(BoardType& board, MoveList& moves, char mover) { generateMoves(board, moves, mover); }
+
+    void setTimeLimit(std::chrono::milliseconds limit) { maxTime = limit; }
+    std::chrono::milliseconds getTimeLimit() const { return maxTime; }
+    void setDepth(int d) { searchDepth = d; }
+    int getDepth() const { return searchDepth; }
+    void setThreads(int n) { threadLimit = n; } // 根節點平行化的執行緒上限
+    // 根節點平行化的輔助執行緒依序綁到 pinCurrentThread(1..n-1)，呼叫端的執行緒不動
+    void setPinThreads(bool pin) { pinThreads = pin; }
+    // 每層保留的候選步數：widths[ply]（0 為根節點，超出的層數沿用最後一個值），0 表示不限；
+    // 走法依潛力圖排序後截斷，空陣列即只排序不剪枝（預設）。截斷可能剪掉最佳步，要自己量過棋力再開，
+    // 例如 batch_analyze --width 0,16,12,10,8
+    void setMoveWidths(std::vector<int> widths) { moveWidths = std::move(widths); }
+    const std::vector<int>& getMoveWidths() const { return moveWidths; }
+    void setOpeningBook(const OpeningBook* b) { book = b; } // nullptr 表示不用開局庫
+    // ProbCut 選擇性剪枝（見 ProbCut.hpp）；預設的空參數即不啟用
+    void setProbCut(const ProbCutParams& p) { probCut = p; }
+    const ProbCutParams& getProbCut() const { return probCut; }
+    void setWeights(const EvalWeights& w) { weights = w; patterns = PatternTable(w); evalCache.clear(); }
+    // 改用神經網路評估；nullptr 切回棋型表。網路的棋盤大小不符時回傳 false 且不切換
+    bool setNetwork(const NnueNetwork* net);
+    void setTableSize(size_t sizeMB) { transpositionTable.resize(sizeMB); }
+    void setEvalCacheSize(size_t sizeKB) { evalCache.resize(sizeKB); }
+    // 置換表 / 評估快取實際採用的記憶體配置，例如 "tt=explicit/interleave eval=normal/local"
+    std::string memoryInfo() const { return "tt=" + transpositionTable.memoryInfo() + " eval=" + evalCache.memoryInfo(); }
+    void setKeepTable(bool keep) { keepTable = keep; } // 搜尋之間不清空置換表（背景思考用）
+    // 外部中止旗標：設為 true 時進行中的搜尋會盡快以目前最佳步返回，nullptr 表示不用
+    void setStopFlag(const std::atomic<bool>* flag) { stopFlag = flag; }
+    // 把展開的搜尋樹串流寫到追蹤檔（見 SearchTrace.hpp），nullptr 表示不追蹤。
+    // 同一個 SearchTrace 可給多個引擎共用；必須比搜尋活得久
+    void setTrace(SearchTrace* t) { trace = t; }
+
+    // 置換表改存到檔案：之後每步不再清空，下次開同一個檔案即可接續先前的分析。
+    // 檔案是別的設定（執子方、規則、評估、剪枝）存的就回傳 false，檔案保持原樣
+    bool attachTableFile(const std::string& path);
+    void detachTableFile() { transpositionTable.detach(); }
+    void flushTableFile() { transpositionTable.flush(); }
+    char getSymbol() const { return symbol; }
+
+    // 8 種對稱的 Zobrist 雜湊，canonical() 即為置換表 / 開局庫的鍵
+    SymmetricHash<N> computeZobristHash(const BoardType& board) const;
+
+private:
+    char symbol;
+    char opponentSymbol;
+    int sign; // 評分以 X 的角度計算，引擎執 O 時取負號
+    const OpeningBook* book = nullptr;
+    int searchDepth = 4; // 根節點之後的搜尋深度
+    int threadLimit = 8;
+    bool pinThreads = false;
+    bool keepTable = false;
+    std::vector<int> moveWidths; // 預設不剪枝
+    std::atomic<uint64_t> nodes{0};
+    std::atomic<uint64_t> evalProbes{0};
+    std::atomic<uint64_t> evalHits{0};
+    std::atomic<uint64_t> probCuts{0};
+    std::atomic<uint64_t> ttHits{0};
+    ProbCutParams probCut;
+
+    // --- 核心演算法 --- //
+    using Accumulator = NnueNetwork::Accumulator;
+    int evaluateBoard(BoardType& board);
+    int evaluateLeaf(BoardType& board, const Accumulator* acc); // 有累加器時直接推論
+    int evaluateCached(BoardType& board, const Accumulator* acc, uint64_t key); // 先查評估快取
+    // lines 不為 nullptr 時禁手改查增量維護的單線編碼（搜尋中），否則直接從盤面編碼
+    void generateMoves(BoardType& board, MoveList& moves, char mover, const LineCodes<N>* lines = nullptr);
+    void orderMoves(MoveList& moves, const PotentialMap<N>& potential, char mover, std::pair<int, int> first, int ply) const;
+    // 落子或提子之後更新潛力圖；有禁手的規則一併更新單線編碼
+    static void updateLocal(const BoardType& board, int r, int c, PotentialMap<N>& potential, LineCodes<N>& lines) {
+        potential.update(board, r, c);
+        if (Rule::hasForbidden) lines.update(board, r, c);
+    }
+    int minimax(BoardType& board, int depth, bool maximizing, int alpha, int beta, const SymmetricHash<N>& hash,
+                const Accumulator* acc, PotentialMap<N>& potential, LineCodes<N>& lines, int ply, SearchTrace::Writer* trace);
+    bool tryProbCut(BoardType& board, int depth, bool maximizing, int alpha, int beta, const SymmetricHash<N>& hash,
+                    const Accumulator* acc, PotentialMap<N>& potential, LineCodes<N>& lines, int ply, int& result);
+    SearchResult findBestMove(BoardType& board);
+    std::pair<int, int> fallbackMove(const BoardType& board) const;
+    void scoreRootMoves(const BoardType& board, const MoveList& moves, int depth, int* scores);
+    void extractPV(BoardType board, SearchResult& result);
+    bool hasDangerousThree(BoardType& board, char checkSymbol);
+
+    // --- 棋型表 --- //
+    EvalWeights weights;
+    PatternTable patterns;
+    const NnueNetwork* network = nullptr; // 不為 nullptr 時取代棋型表，累加器隨走法逐層更新
+
+    // --- 時間控制 --- //
+    std::chrono::milliseconds maxTime{1000};  // 最大思考時間
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<bool> timeUp{false};
+    const std::atomic<bool>* stopFlag = nullptr;
+    SearchTrace* trace = nullptr;
+    bool outOfTime();
+
+    // --- Zobrist Hashing --- //
+    TranspositionTable transpositionTable; // 只存搜尋結果
+    EvalCache evalCache;                   // 葉節點的靜態評估；評估函式不變就一直有效，搜尋之間不清空
+};
+
+extern template class SearchEngine<15, FreestyleRule>;
+extern template class SearchEngine<19, FreestyleRule>;
+extern template class SearchEngine<15, StandardRule>;
+extern template class SearchEngine<19, StandardRule>;
+extern template class SearchEngine<15, RenjuRule>;
+extern template class SearchEngine<19, RenjuRule>;
+
+#endif
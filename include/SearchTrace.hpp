@@ -0,0 +1,144 @@
+#ifndef SEARCHTRACE_HPP
+#define SEARCHTRACE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// --- 搜尋樹追蹤檔 --- //
+// 把 minimax 實際展開的節點依走訪順序串流寫出，用來檢查走法排序與剪枝；
+// 樹不留在記憶體裡，數千萬節點的搜尋也只佔每條執行緒一個緩衝區。
+// 檔案（little-endian）= 8 bytes 魔術字 "GMKTRC1\0" + u8 棋盤大小 + 3 bytes 保留，之後是一塊塊的資料：
+//   u32 搜尋編號 | u16 執行緒 | u16 保留 | u32 資料長度 | 紀錄...
+// 同一條執行緒、同一次搜尋的資料塊依序出現，不同執行緒的資料塊互相穿插。紀錄有三種：
+//   ENTER  u8 1 | u8 ply | u8 row | u8 col | u8 depth | i32 alpha | i32 beta   進入節點（前序）
+//   EXIT   u8 2 | u8 結束原因 | u8 旗標 | u16 展開的子節點數 | i32 score        離開節點
+//   SEARCH u8 3 | u8 深度 | u8 執子方 | u16 子數 | 每子 u16 格子編號 + u8 顏色   一次搜尋的根局面（執行緒 0xFFFF）
+// 根節點本身不是 minimax 節點，ply 1 的節點即各個根節點走法
+class SearchTrace {
+public:
+    enum Reason : uint8_t {
+        LEAF = 0,      // 深度用完或棋盤已滿，靜態評估
+        TT_CUT = 1,    // 置換表的結果已足夠
+        CUTOFF = 2,    // alpha >= beta，剩下的走法剪掉
+        EXHAUSTED = 3, // 所有走法都搜完
+        WIN = 4,       // 這一步直接連成五，不再往下
+        TIMEOUT = 5,   // 時間到或被中止，結果不完整
+        PROBCUT = 6,   // 淺層搜尋預測會落在窗口外，直接回傳窗口邊界（淺層搜尋本身不寫入追蹤檔）
+    };
+    enum Flag : uint8_t { TT_HIT = 1, MAXIMIZING = 2 };
+    enum Tag : uint8_t { ENTER = 1, EXIT = 2, SEARCH = 3 };
+    static const uint16_t SEARCH_THREAD = 0xFFFF;
+    static const size_t FILE_HEADER_SIZE = 12;
+    static const size_t CHUNK_HEADER_SIZE = 12;
+
+    SearchTrace() = default;
+    ~SearchTrace();
+    SearchTrace(const SearchTrace&) = delete;
+    SearchTrace& operator=(const SearchTrace&) = delete;
+
+    bool open(const std::string& path, int boardSize); // 覆寫既有檔案
+    void close();
+    bool isOpen() const { return out != nullptr; }
+
+    // 開始一次搜尋（一次 scoreRootMoves）：記下根局面並回傳搜尋編號
+    uint32_t beginSearch(const std::vector<std::pair<int, char>>& stones, int depth, char mover);
+
+    // 單一執行緒的緩衝寫入器：只累積完整的紀錄，滿了才整塊寫到檔案，解構時寫出剩下的部分
+    class Writer {
+    public:
+        Writer(SearchTrace& trace, uint32_t search, uint16_t thread);
+        ~Writer();
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void enter(int ply, int row, int col, int depth, int alpha, int beta) {
+            if (used + 13 > buffer.size()) flush();
+            unsigned char* p = buffer.data() + used;
+            p[0] = ENTER;
+            p[1] = static_cast<unsigned char>(ply);
+            p[2] = static_cast<unsigned char>(row);
+            p[3] = static_cast<unsigned char>(col);
+            p[4] = static_cast<unsigned char>(depth);
+            put32(p + 5, static_cast<uint32_t>(alpha));
+            put32(p + 9, static_cast<uint32_t>(beta));
+            used += 13;
+        }
+
+        void exit(int score, Reason reason, uint8_t flags, int children) {
+            if (used + 9 > buffer.size()) flush();
+            unsigned char* p = buffer.data() + used;
+            p[0] = EXIT;
+            p[1] = reason;
+            p[2] = flags;
+            p[3] = static_cast<unsigned char>(children & 0xFF);
+            p[4] = static_cast<unsigned char>((children >> 8) & 0xFF);
+            put32(p + 5, static_cast<uint32_t>(score));
+            used += 9;
+        }
+
+        void flush();
+
+    private:
+        SearchTrace& trace;
+        uint32_t search;
+        uint16_t thread;
+        std::vector<unsigned char> buffer;
+        size_t used = 0;
+
+        static void put32(unsigned char* p, uint32_t v) {
+            p[0] = v & 0xFF;
+            p[1] = (v >> 8) & 0xFF;
+            p[2] = (v >> 16) & 0xFF;
+            p[3] = v >> 24;
+        }
+    };
+
+private:
+    FILE* out = nullptr;
+    std::mutex mutex;
+    uint32_t nextSearch = 0;
+
+    void writeChunk(uint32_t search, uint16_t thread, const unsigned char* data, size_t length);
+};
+
+// 依檔案順序逐塊讀取；資料塊的內容交給呼叫端逐筆解析
+class SearchTraceReader {
+public:
+    struct Chunk {
+        uint32_t search;
+        uint16_t thread;
+        std::vector<unsigned char> data;
+    };
+
+    // 解析後的一筆紀錄（依 tag 只有部分欄位有效）
+    struct Record {
+        uint8_t tag;
+        int ply, row, col, depth, alpha, beta;       // ENTER
+        int reason, flags, children, score;          // EXIT
+        int searchDepth;                             // SEARCH
+        char mover;                                  // SEARCH
+        std::vector<std::pair<int, char>> stones;    // SEARCH：格子編號與 'X' / 'O'
+    };
+
+    ~SearchTraceReader();
+    bool open(const std::string& path);
+    void close();
+    int boardSize() const { return size; }
+    bool next(Chunk& chunk);                // 沒有下一塊或檔案截斷時回傳 false
+    bool skip(uint32_t& search, uint16_t& thread); // 只讀資料塊標頭（快速掃描）
+
+    // 從 data[pos] 解析一筆紀錄並前進 pos；資料不完整時回傳 false
+    static bool parse(const std::vector<unsigned char>& data, size_t& pos, Record& record);
+
+private:
+    FILE* in = nullptr;
+    int size = 0;
+
+    bool readHeader(uint32_t& search, uint16_t& thread, uint32_t& length);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef SPARSEBOARD_HPP
+#define SPARSEBOARD_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 以座標為鍵的稀疏棋盤，給超大或無邊界的變體使用；
+// 介面與 Board 相同，另外記錄所有棋子與外框範圍，讓每步成本只跟棋子數有關
+class SparseBoard {
+public:
+    struct Stone {
+        int row;
+        int col;
+        char symbol;
+    };
+
+    explicit SparseBoard(int limit = 0); // limit > 0 為 limit x limit 的有限棋盤，0 為無邊界
+
+    bool placePiece(int row, int col, char symbol);
+    void removePiece(int row, int col); // 搜尋時還原落子用
+    char getCell(int row, int col) const;
+    int cellCode(int row, int col) const; // 0: 空, 1: X, 2: O, 3: 棋盤外
+    bool isFull() const;
+    bool isWin(int row, int col, char symbol) const;
+    void reset();
+
+    bool inBounds(int row, int col) const {
+        return limit <= 0 || (row >= 0 && row < limit && col >= 0 && col < limit);
+    }
+    int getLimit() const { return limit; }
+    int stoneCount() const { return static_cast<int>(stones.size()); }
+    const std::vector<Stone>& getStones() const { return stones; }
+
+    // 外框範圍（無棋子時不可使用）
+    int minRow() const { return top; }
+    int maxRow() const { return bottom; }
+    int minCol() const { return left; }
+    int maxCol() const { return right; }
+
+    static uint64_t key(int row, int col) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) | static_cast<uint32_t>(col);
+    }
+
+private:
+    int limit;
+    std::unordered_map<uint64_t, int> index; // 座標 -> stones 的位置
+    std::vector<Stone> stones;
+    int top = 0, bottom = -1, left = 0, right = -1;
+
+    void recomputeBounds();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SPARSESEARCHENGINE_HPP
+#define SPARSESEARCHENGINE_HPP
+
+#include "SparseBoard.hpp"
+#include "PatternTable.hpp"
+#include "Rules.hpp"
+#include "SearchEngine.hpp"
+#include "TranspositionTable.hpp"
+#include <utility>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// 稀疏棋盤用的搜尋：走法產生與評估只掃描棋子周圍，
+// 不會走訪整個棋盤面積。規則、根節點平行化、中止旗標與主要變化的用法同 SearchEngine；
+// 沒有開局庫、網路評估、潛力圖排序與剪枝，給 SearchEngine 不支援的棋盤大小（pbrain --sparse）使用
+template <class Rule = ActiveRule>
+class SparseSearchEngine {
+public:
+    SparseSearchEngine(char symbol, size_t ttSizeMB = 16);
+
+    // 清空置換表並在時間限制內找出最佳步
+    std::pair<int, int> search(SparseBoard& board) { return analyze(board).move; }
+    // 同 search，另外回報分數、主要變化與節點數；有界棋盤上無步可下時 source 為 "none"、move 為 {-1, -1}
+    SearchResult analyze(SparseBoard& board);
+
+    // 個別核心的入口，kernel_fuzz 拿來和 SearchEngine<15> 比對
+    int evaluateBoard(const SparseBoard& board) { return evaluate(board, main); }
+    void generateMoves(const SparseBoard& board, std::vector<std::pair<int, int>>& moves, char mover) {
+        generate(board, moves, mover, main);
+    }
+
+    void setTimeLimit(std::chrono::milliseconds limit) { maxTime = limit; }
+    void setDepth(int d) { depth = d; }
+    void setThreads(int n) { threadLimit = n; } // 根節點平行化的執行緒上限
+    void setTableSize(size_t sizeMB) { transpositionTable.resize(sizeMB); }
+    // 外部中止旗標：設為 true 時進行中的搜尋會盡快以目前最佳步返回，nullptr 表示不用
+    void setStopFlag(const std::atomic<bool>* flag) { stopFlag = flag; }
+    char getSymbol() const { return symbol; }
+
+    static uint64_t zobristKey(int row, int col, char symbol);
+    static uint64_t computeZobristHash(const SparseBoard& board);
+
+private:
+    char symbol;
+    char opponentSymbol;
+    int sign; // 評分以 X 的角度計算，引擎執 O 時取負號
+    int depth = 4;
+    int threadLimit = 8;
+
+    PatternTable patterns;
+    TranspositionTable transpositionTable;
+
+    // 評估用暫存：(線編號, 線上位置)
+    struct LinePoint {
+        int64_t line;
+        int pos;
+        bool operator<(const LinePoint& o) const { return line != o.line ? line < o.line : pos < o.pos; }
+    };
+    // 每個執行緒一份的暫存，跨呼叫重複使用
+    struct Worker {
+        std::vector<LinePoint> scratch;
+        std::vector<uint64_t> seen;
+        std::vector<std::vector<std::pair<int, int>>> plyMoves; // 每層一份
+    };
+    Worker main; // 呼叫端執行緒（根節點與單一核心的入口）使用
+
+    std::chrono::milliseconds maxTime{1000};  // 最大思考時間
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<bool> timeUp{false};
+    const std::atomic<bool>* stopFlag = nullptr;
+    std::atomic<uint64_t> nodes{0};
+    bool outOfTime();
+
+    int evaluate(const SparseBoard& board, Worker& w);
+    void generate(const SparseBoard& board, std::vector<std::pair<int, int>>& moves, char mover, Worker& w);
+    int minimax(SparseBoard& board, int depth, int ply, bool maximizing, int alpha, int beta, uint64_t hash, Worker& w);
+    void scoreRootMoves(const SparseBoard& board, const std::vector<std::pair<int, int>>& moves, int* scores);
+    void extractPV(SparseBoard board, SearchResult& result);
+    bool fallbackMove(const SparseBoard& board, std::pair<int, int>& move) const;
+
+    // 置換表的走法欄位只有 8 位元：存相對於外框左上角的位移（-1 起），外框太大就不存
+    static bool packMove(const SparseBoard& board, std::pair<int, int> move, int& row, int& col);
+};
+
+extern template class SparseSearchEngine<FreestyleRule>;
+extern template class SparseSearchEngine<StandardRule>;
+extern template class SparseSearchEngine<RenjuRule>;
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定數量的工作執行緒，工作依提交順序 (FIFO) 執行
+// 多個對局共用同一個池，總執行緒數不會超過核心數
+class ThreadPool {
+public:
+    // threads 為 0 表示使用硬體執行緒數；pin 時第 i 條工作執行緒綁到 pinCurrentThread(i) 的位置
+    explicit ThreadPool(int threads = 0, bool pin = false);
+    ~ThreadPool();                        // 等待已提交的工作做完再結束
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    int size() const { return static_cast<int>(workers.size()); }
+    size_t pending() const; // 尚未開始的工作數
+    int busy() const;       // 正在執行的工作數
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    mutable std::mutex mutex;
+    std::condition_variable ready;
+    bool stopping = false;
+    int running = 0;
+
+    void workerLoop(int index, bool pin);
+};
+
+#endif
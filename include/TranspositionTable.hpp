@@ -0,0 +1,72 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include "LargePages.hpp"
+#include "MappedFile.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 固定大小的置換表：建構時一次配置，搜尋中只做覆寫。
+// 記憶體依 largePagePolicy() 配置（大頁、NUMA 分散），數 GB 的表格查詢時 TLB 失誤較少
+// 每個槽位存 key ^ data，讀取時再驗證一次，多執行緒不需上鎖
+class TranspositionTable {
+public:
+    enum Bound : uint8_t { EXACT = 0, LOWER = 1, UPPER = 2 };
+
+    struct Entry {
+        int score;
+        int depth;
+        Bound bound;
+        int row;
+        int col;
+    };
+
+    // 存檔標頭：版本、槽位數與 signature 都對得上才沿用檔案內容
+    struct FileHeader {
+        char magic[8];       // "GMKTT\0\0\0"
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t slotCount;
+        uint64_t signature;  // 棋盤大小、規則、執子方與 Zobrist 表的指紋
+    };
+    static const uint32_t FILE_VERSION = 1;
+
+    explicit TranspositionTable(size_t sizeMB = 16);
+
+    void resize(size_t sizeMB); // 重新配置（內容清空）；已掛上檔案時會先寫回並卸下
+    void clear();
+    bool probe(uint64_t key, Entry& out) const;
+    void store(uint64_t key, int score, int depth, Bound bound, int row = -1, int col = -1);
+    size_t capacity() const { return slotCount; }
+    std::string memoryInfo() const; // 實際的頁面 / NUMA 配置，例如 "thp/interleave"、"file"
+
+    // --- 存檔 --- //
+    // 改用 path 的記憶體映射當作置換表本體：檔案有效就直接沿用（頁面用到才載入），
+    // 不存在就以目前大小建立。檔案已存在但不是置換表、或 signature 不同（另一方執子、換了權重等）
+    // 時回傳 false，不覆寫使用者的檔案。之後的寫入都會落在檔案上
+    bool attach(const std::string& path, uint64_t signature);
+    void detach(); // 寫回並改回記憶體內的表
+    void flush();
+    bool isPersistent() const { return file.isOpen(); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0}; // key ^ data
+        std::atomic<uint64_t> data{0};
+    };
+    static_assert(sizeof(Slot) == 16, "槽位需與檔案格式一致");
+
+    LargeBuffer heap; // 全 0 即空表，配置後不需再初始化
+    MappedFile file;
+    Slot* slots;
+    size_t slotCount;
+    uint64_t mask;
+
+    void allocateHeap();
+    static uint64_t pack(int score, int depth, Bound bound, int row, int col);
+    static Entry unpack(uint64_t data);
+};
+
+#endif
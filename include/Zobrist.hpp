@@ -0,0 +1,113 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+#include <utility>
+
+// --- 棋盤的 8 種對稱 --- //
+// k 的低兩位為順時針旋轉 90 度的次數，第三位表示旋轉後再左右鏡射
+constexpr std::pair<int, int> applySymmetry(int n, int k, int row, int col) {
+    int r = row, c = col;
+    for (int i = 0; i < (k & 3); ++i) {
+        int t = r;
+        r = c;
+        c = n - 1 - t;
+    }
+    if (k & 4) c = n - 1 - c;
+    return {r, c};
+}
+
+template <int N>
+constexpr std::pair<int, int> applySymmetry(int k, int row, int col) {
+    return applySymmetry(N, k, row, col);
+}
+
+constexpr int inverseSymmetry(int k) {
+    return (k & 4) ? k : ((4 - k) & 3); // 鏡射本身可逆，純旋轉取反方向
+}
+
+// 編譯期產生的 Zobrist 亂數表，依棋盤大小各一份；
+// 固定種子讓不同行程算出的雜湊一致（開局庫、置換表存檔會用到）
+template <int N>
+struct ZobristKeys {
+    uint64_t key[N][N][2];      // [row][col][0: X, 1: O]
+    uint64_t sym[N][N][2][8];   // 落在 (row, col) 的棋子在第 k 種對稱下對應的 key
+
+    constexpr ZobristKeys() : key{}, sym{} {
+        uint64_t state = 42 + N;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                for (int s = 0; s < 2; ++s) {
+                    // splitmix64
+                    state += 0x9E3779B97F4A7C15ULL;
+                    uint64_t z = state;
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                    key[i][j][s] = z ^ (z >> 31);
+                }
+            }
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                for (int k = 0; k < 8; ++k) {
+                    auto t = applySymmetry<N>(k, i, j);
+                    sym[i][j][0][k] = key[t.first][t.second][0];
+                    sym[i][j][1][k] = key[t.first][t.second][1];
+                }
+            }
+        }
+    }
+
+    constexpr uint64_t operator()(int row, int col, char symbol) const {
+        return key[row][col][symbol == 'X' ? 0 : 1];
+    }
+};
+
+template <int N>
+inline constexpr ZobristKeys<N> zobristKeys{};
+
+// 同時維護 8 種對稱局面的雜湊；查表時取最小值當作標準形，
+// 互為對稱的局面因此共用同一個置換表 / 開局庫項目
+template <int N>
+struct SymmetricHash {
+    uint64_t h[8] = {};
+
+    void toggle(int row, int col, char symbol) {
+        const uint64_t* keys = zobristKeys<N>.sym[row][col][symbol == 'X' ? 0 : 1];
+        for (int k = 0; k < 8; ++k) h[k] ^= keys[k];
+    }
+
+    SymmetricHash with(int row, int col, char symbol) const {
+        SymmetricHash next = *this;
+        next.toggle(row, col, symbol);
+        return next;
+    }
+
+    // 傳回標準形雜湊，k 為「實際局面 -> 標準形」所用的對稱
+    uint64_t canonical(int& k) const {
+        k = 0;
+        for (int i = 1; i < 8; ++i)
+            if (h[i] < h[k]) k = i;
+        return h[k];
+    }
+
+    uint64_t canonical() const {
+        int k;
+        return canonical(k);
+    }
+};
+
+// 從整個棋盤算出對稱雜湊（BoardT 為 BasicBoard<N>）
+template <class BoardT>
+SymmetricHash<BoardT::SIZE> hashPosition(const BoardT& board) {
+    SymmetricHash<BoardT::SIZE> hash;
+    for (int i = 0; i < BoardT::SIZE; ++i) {
+        for (int j = 0; j < BoardT::SIZE; ++j) {
+            char cell = board.getCell(i, j);
+            if (cell != '.') hash.toggle(i, j, cell);
+        }
+    }
+    return hash;
+}
+
+#endif
@@ -1,16 +1,43 @@
 #include <SFML/Graphics.hpp>
 #include <memory>
 #include <iostream>
-#include "HumanPlayer.hpp"
-#include "AIPlayer.hpp"
 #include "GameWindow.hpp"
+#include "FrameStats.hpp"
+#include <string>
 
 const float VIRTUAL_WIDTH = 600;
 const float VIRTUAL_HEIGHT = 660;  // 多出 60px 顯示資訊欄
+const int FRAME_RATE_LIMIT = 60;   // 逐幀計時以此判斷掉幀
+
+// main [--replay games.gmr] [--frame-csv frames.csv] [--frame-log] [--frame-overlay]
+//   --replay        直接進入重播，選單上的 Replay Games 也改播這個檔案（預設是對局時寫入的 games.gmr）
+//   --frame-csv     每秒寫一列畫面計時的彙總（展示機台收集用）
+//   --frame-log     卡頓的幀寫到 stderr（遊戲中按 F4 切換）
+//   --frame-overlay 一開始就顯示計時面板（遊戲中按 F3 切換）
+int main(int argc, char** argv) {
+    FrameStats frameStats(FRAME_RATE_LIMIT);
+    std::string replayPath = "games.gmr";
+    bool startInReplay = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--frame-csv" && i + 1 < argc) {
+            if (!frameStats.openCsv(argv[++i])) {
+                std::cerr << "Cannot write " << argv[i] << "\n";
+                return -1;
+            }
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+            startInReplay = true;
+        } else if (arg == "--frame-log") frameStats.setLogEnabled(true);
+        else if (arg == "--frame-overlay") frameStats.setOverlayVisible(true);
+        else {
+            std::cerr << "usage: main [--replay <games.gmr>] [--frame-csv <file>] [--frame-log] [--frame-overlay]\n";
+            return -1;
+        }
+    }
 
-int main() {
     sf::RenderWindow window(sf::VideoMode(VIRTUAL_WIDTH, VIRTUAL_HEIGHT), "Gomoku", sf::Style::Titlebar | sf::Style::Close);
-    window.setFramerateLimit(60);
+    window.setFramerateLimit(FRAME_RATE_LIMIT);
 
     sf::Font font;
     if (!font.loadFromFile("arial.ttf")) {
@@ -19,20 +46,19 @@ int main() {
     }
 
     while (window.isOpen()) {
-        bool isPvP;
-        if (!GameWindow::showModeSelection(window, font, isPvP)) return -1;
-
-        while (window.isOpen()) {
-            std::unique_ptr<Player> p1 = std::make_unique<HumanPlayer>('X');
-            std::unique_ptr<Player> p2;
+        bool isPvP = false;
+        bool isReplay = startInReplay;
+        startInReplay = false;
+        if (!isReplay && !GameWindow::showModeSelection(window, font, isPvP, isReplay)) return -1;
 
-            if (isPvP) {
-                p2 = std::make_unique<HumanPlayer>('O');
-            } else {
-                p2 = std::make_unique<AIPlayer>('O');
-            }
+        if (isReplay) {
+            GameWindow replayWindow(true, &frameStats);
+            if (replayWindow.runReplay(window, font, replayPath) == GameResult::Exit) window.close();
+            continue;
+        }
 
-            GameWindow gameWindow(std::move(p1), std::move(p2), isPvP);
+        while (window.isOpen()) {
+            GameWindow gameWindow(isPvP, &frameStats);
             GameResult result = gameWindow.run(window, font);
 
             if (!window.isOpen()) break;
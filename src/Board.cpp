@@ -1,43 +1,60 @@
 #include "Board.hpp"
+#include <cstring>
+#include <type_traits>
 
-Board::Board() : grid(SIZE, std::vector<char>(SIZE, '.')) {}
+static_assert(std::is_trivially_copyable<Board>::value, "Board 必須可以直接 memcpy");
+static_assert(sizeof(Board) == 64, "15x15 的 Board 應剛好佔一條 cache line");
+static_assert(sizeof(Board19) == 128, "19x19 的 Board 應佔兩條 cache line");
+
+template <int N>
+BasicBoard<N>::BasicBoard() {
+    reset();
+}
 
 
-void Board::reset() {
-    grid = std::vector<std::vector<char>>(SIZE, std::vector<char>(SIZE, ' '));
+template <int N>
+void BasicBoard<N>::reset() {
+    std::memset(bits, 0, sizeof(bits));
 }
 
 
-bool Board::placePiece(int row, int col, char symbol) {
-    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE || grid[row][col] != '.') return false;
-    grid[row][col] = symbol;
+template <int N>
+bool BasicBoard<N>::placePiece(int row, int col, char symbol) {
+    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE || code(row, col) != 0) return false;
+    int idx = row * SIZE + col;
+    bits[idx / CELLS_PER_WORD] |= encode(symbol) << ((idx % CELLS_PER_WORD) * 2);
     return true;
 }
 
-char Board::getCell(int row, int col) const {
-    return grid[row][col];
+template <int N>
+void BasicBoard<N>::removePiece(int row, int col) {
+    int idx = row * SIZE + col;
+    bits[idx / CELLS_PER_WORD] &= ~(uint64_t(3) << ((idx % CELLS_PER_WORD) * 2));
 }
 
-bool Board::isFull() const {
-    for (const auto& row : grid)
-        for (char c : row)
-            if (c == '.') return false;
-    return true;
+template <int N>
+bool BasicBoard<N>::isFull() const {
+    // 每格兩個 bit 只要有一個為 1 即代表有子，合併後計算數量
+    int stones = 0;
+    for (uint64_t w : bits)
+        stones += __builtin_popcountll((w | (w >> 1)) & 0x5555555555555555ULL);
+    return stones == SIZE * SIZE;
 }
 
-bool Board::isWin(int row, int col, char symbol)  {  // 添加 const
+template <int N>
+bool BasicBoard<N>::isWin(int row, int col, char symbol) const {
     int dirs[4][2] = {{0,1},{1,0},{1,1},{1,-1}};
     for (auto& dir : dirs) {
         int dr = dir[0], dc = dir[1];
         int count = 1;
         for (int i = 1; i < 5; ++i) {
             int r = row + dr*i, c = col + dc*i;
-            if (r < 0 || r >= SIZE || c < 0 || c >= SIZE || grid[r][c] != symbol) break;
+            if (r < 0 || r >= SIZE || c < 0 || c >= SIZE || getCell(r, c) != symbol) break;
             count++;
         }
         for (int i = 1; i < 5; ++i) {
             int r = row - dr*i, c = col - dc*i;
-            if (r < 0 || r >= SIZE || c < 0 || c >= SIZE || grid[r][c] != symbol) break;
+            if (r < 0 || r >= SIZE || c < 0 || c >= SIZE || getCell(r, c) != symbol) break;
             count++;
         }
         if (count >= 5) return true;
@@ -45,8 +62,5 @@ bool Board::isWin(int row, int col, char symbol)  {  // 添加 const
     return false;
 }
 
-
-
-
-
-
+template class BasicBoard<15>;
+template class BasicBoard<19>;
@@ -0,0 +1,21 @@
+#include "EvalCache.hpp"
+#include <new>
+
+EvalCache::EvalCache(size_t sizeKB) {
+    resize(sizeKB);
+}
+
+void EvalCache::resize(size_t sizeKB) {
+    // 取不超過指定大小的 2 的冪次，索引只需要做 AND
+    size_t wanted = (sizeKB * 1024) / sizeof(uint64_t);
+    slotCount = 1;
+    while (slotCount * 2 <= wanted) slotCount *= 2;
+    mask = slotCount - 1;
+    buffer.release();
+    if (!buffer.allocate(slotCount * sizeof(uint64_t))) throw std::bad_alloc();
+    slots = static_cast<std::atomic<uint64_t>*>(buffer.data()); // 配置到的記憶體全為 0，即空槽位
+}
+
+void EvalCache::clear() {
+    for (size_t i = 0; i < slotCount; ++i) slots[i].store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,128 @@
+#include "FrameStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+const char* const FrameStats::PHASE_NAMES[PHASE_COUNT] = {"events", "update", "draw", "result", "overlay", "display"};
+const double FrameStats::HISTOGRAM_EDGES_MS[HISTOGRAM_BUCKETS - 1] = {4, 8, 12, 17, 20, 33, 50, 100};
+
+// 超過幾個時間格就寫一行卡頓紀錄（60 FPS 時約 67 ms，肉眼看得出來的停頓）
+static const int LOG_DROPPED_FRAMES = 3;
+
+int FrameStats::bucketOf(double ms) {
+    return static_cast<int>(std::upper_bound(HISTOGRAM_EDGES_MS, HISTOGRAM_EDGES_MS + HISTOGRAM_BUCKETS - 1, ms) -
+                            HISTOGRAM_EDGES_MS);
+}
+
+FrameStats::FrameStats(int targetFps) : budget(1000.0 / std::max(1, targetFps)) {
+    ring.reserve(RECENT_FRAMES);
+}
+
+FrameStats::~FrameStats() {
+    closeCsv();
+}
+
+bool FrameStats::openCsv(const std::string& path) {
+    closeCsv();
+    csv = std::fopen(path.c_str(), "w");
+    if (!csv) return false;
+    std::fprintf(csv, "elapsed_s,frames,avg_frame_ms,max_frame_ms");
+    for (const char* name : PHASE_NAMES) std::fprintf(csv, ",avg_%s_ms", name);
+    std::fprintf(csv, ",avg_draw_calls,dropped");
+    for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+        if (b + 1 < HISTOGRAM_BUCKETS) std::fprintf(csv, ",hist_lt%g", HISTOGRAM_EDGES_MS[b]);
+        else std::fprintf(csv, ",hist_ge%g", HISTOGRAM_EDGES_MS[b - 1]);
+    }
+    std::fprintf(csv, "\n");
+    std::fflush(csv);
+    csvStart = rowStart = Clock::now();
+    rowFrames = 0;
+    return true;
+}
+
+void FrameStats::closeCsv() {
+    if (!csv) return;
+    if (rowFrames > 0) writeRow(Clock::now());
+    std::fclose(csv);
+    csv = nullptr;
+}
+
+void FrameStats::beginFrame() {
+    current = Frame();
+    frameStart = mark = Clock::now();
+}
+
+void FrameStats::endPhase(Phase phase) {
+    Clock::time_point now = Clock::now();
+    current.phaseMs[phase] += msSince(mark, now);
+    mark = now;
+}
+
+void FrameStats::endFrame() {
+    endPhase(DISPLAY);
+    current.totalMs = msSince(frameStart, mark);
+    // 幀率上限的等待本身有誤差，四捨五入到時間格才不會把 17 ms 的一幀當成掉幀
+    current.dropped = std::max(0, static_cast<int>(std::lround(current.totalMs / budget)) - 1);
+    ++frames;
+    droppedFrames += current.dropped;
+
+    if (ring.size() < static_cast<size_t>(RECENT_FRAMES)) ring.push_back(current);
+    else ring[ringNext] = current;
+    ringNext = (ringNext + 1) % RECENT_FRAMES;
+
+    if (log && current.dropped >= LOG_DROPPED_FRAMES) {
+        std::fprintf(stderr, "frame %llu: %.1f ms (", static_cast<unsigned long long>(frames), current.totalMs);
+        for (int p = 0; p < PHASE_COUNT; ++p)
+            std::fprintf(stderr, "%s%s %.2f", p ? ", " : "", PHASE_NAMES[p], current.phaseMs[p]);
+        std::fprintf(stderr, "), %d draws, %d dropped\n", current.drawCalls, current.dropped);
+    }
+
+    if (csv) {
+        ++rowFrames;
+        rowTotalMs += current.totalMs;
+        rowMaxMs = std::max(rowMaxMs, current.totalMs);
+        for (int p = 0; p < PHASE_COUNT; ++p) rowPhaseMs[p] += current.phaseMs[p];
+        rowDrawCalls += current.drawCalls;
+        rowDropped += current.dropped;
+        ++rowHistogram[bucketOf(current.totalMs)];
+        if (msSince(rowStart, mark) >= 1000) writeRow(mark);
+    }
+}
+
+void FrameStats::writeRow(Clock::time_point now) {
+    const double n = std::max(1, rowFrames);
+    std::fprintf(csv, "%.3f,%d,%.3f,%.3f", msSince(csvStart, now) / 1000, rowFrames, rowTotalMs / n, rowMaxMs);
+    for (double ms : rowPhaseMs) std::fprintf(csv, ",%.3f", ms / n);
+    std::fprintf(csv, ",%.1f,%d", rowDrawCalls / n, rowDropped);
+    for (int count : rowHistogram) std::fprintf(csv, ",%d", count);
+    std::fprintf(csv, "\n");
+    std::fflush(csv); // 機台可能直接斷電，每列都寫出
+
+    rowStart = now;
+    rowFrames = rowDropped = 0;
+    rowTotalMs = rowMaxMs = 0;
+    std::fill(rowPhaseMs, rowPhaseMs + PHASE_COUNT, 0.0);
+    rowDrawCalls = 0;
+    std::fill(rowHistogram, rowHistogram + HISTOGRAM_BUCKETS, 0);
+}
+
+FrameStats::Summary FrameStats::recent() const {
+    Summary s;
+    s.frames = static_cast<int>(ring.size());
+    if (ring.empty()) return s;
+    double draws = 0;
+    for (const Frame& f : ring) {
+        s.avgMs += f.totalMs;
+        s.maxMs = std::max(s.maxMs, f.totalMs);
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            s.phaseAvgMs[p] += f.phaseMs[p];
+            s.phaseMaxMs[p] = std::max(s.phaseMaxMs[p], f.phaseMs[p]);
+        }
+        draws += f.drawCalls;
+        s.dropped += f.dropped;
+        ++s.histogram[bucketOf(f.totalMs)];
+    }
+    s.avgMs /= s.frames;
+    for (double& ms : s.phaseAvgMs) ms /= s.frames;
+    s.avgDrawCalls = draws / s.frames;
+    return s;
+}
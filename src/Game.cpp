@@ -19,6 +19,10 @@ void Game::run(sf::RenderWindow& window) {
         // 每回合處理玩家的移動
         int row, col;
         players[current]->makeMove(board, row, col);
+        if (row < 0) {
+            std::cout << "Player " << players[current]->getSymbol() << " has no legal move.\n";
+            break;
+        }
 
         // 檢查移動是否合法
         if (!board.placePiece(row, col, players[current]->getSymbol())) {
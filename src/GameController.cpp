@@ -1,70 +1,213 @@
 #include "GameController.hpp"
+#include <iostream>
 
-GameController::GameController(bool vsAI) : gameOver(false), winner('.') {
-    p1 = new HumanPlayer('X');
-    p2 = vsAI ? static_cast<Player*>(new AIPlayer('O')) : static_cast<Player*>(new HumanPlayer('O'));
-    current = p1;
+GameController::GameController(bool vsAI, ThreadPool* sharedExecutor) : executor(sharedExecutor) {
+    players[0] = std::make_unique<HumanPlayer>('X');
+    if (vsAI) players[1] = std::make_unique<AIPlayer>('O');
+    else players[1] = std::make_unique<HumanPlayer>('O');
+
+    if (!executor) {
+        ownExecutor = std::make_unique<ThreadPool>(1);
+        executor = ownExecutor.get();
+    }
+
+    auto* ai = dynamic_cast<AIPlayer*>(players[1].get());
+    timeLimit = ai ? ai->getTimeLimit() : std::chrono::milliseconds(1000);
+    if (ai) ai->setStopFlag(&stopFlag);
 }
 
 GameController::~GameController() {
-    delete p1;
-    delete p2;
+    // 搜尋工作持有 this，必須等它放手才能拆掉
+    std::unique_lock<std::mutex> lock(mutex);
+    stopFlag = true;
+    idle.wait(lock, [this] { return !thinking; });
 }
 
-const Board& GameController::getBoard() const {
+Board GameController::getBoard() const {
+    std::lock_guard<std::mutex> lock(mutex);
     return board;
 }
 
 char GameController::getCurrentSymbol() const {
-    return current->getSymbol();
+    std::lock_guard<std::mutex> lock(mutex);
+    return players[turn]->getSymbol();
 }
 
-bool GameController::makeMove(int row, int col) {
-    if (gameOver || board.getCell(row, col) != '.') return false;
+bool GameController::isGameOver() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return gameOver;
+}
 
-    if (!board.placePiece(row, col, current->getSymbol())) return false;
+char GameController::getWinnerSymbol() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return winner;
+}
 
-    if (board.isWin(row, col, current->getSymbol())) {
-        gameOver = true;
-        winner = current->getSymbol();
-        return true;
-    }
+bool GameController::isThinking() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return thinking;
+}
+
+std::vector<std::pair<int, int>> GameController::getHistory() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return history;
+}
+
+void GameController::setTimeLimit(std::chrono::milliseconds limit) {
+    std::lock_guard<std::mutex> lock(mutex);
+    timeLimit = limit;
+}
+
+AIPlayer* GameController::aiToMove() const {
+    return dynamic_cast<AIPlayer*>(players[turn].get());
+}
+
+GameController::Reply GameController::snapshotLocked(Status status) const {
+    Reply reply;
+    reply.status = status;
+    reply.gameOver = gameOver;
+    reply.winner = winner;
+    return reply;
+}
+
+// 已經決定好的結果：直接放進 future；回呼在呼叫端的執行緒上執行
+static std::future<GameController::Reply> readyReply(const GameController::Reply& reply,
+                                                     const GameController::ReplyCallback& onReply) {
+    std::promise<GameController::Reply> promise;
+    promise.set_value(reply);
+    if (onReply) onReply(reply);
+    return promise.get_future();
+}
+
+bool GameController::placeLocked(int row, int col) {
+    const char symbol = players[turn]->getSymbol();
+    if (gameOver || row < 0 || row >= Board::SIZE || col < 0 || col >= Board::SIZE) return false;
+    if (board.getCell(row, col) != '.') return false;
+    if (ActiveRule::isForbidden(board, row, col, symbol)) return false; // 禁手
+    if (!board.placePiece(row, col, symbol)) return false;
 
-    if (board.isFull()) {
+    history.emplace_back(row, col);
+    recorder.addMove(row, col);
+
+    if (ActiveRule::isWin(board, row, col, symbol)) {
+        gameOver = true;
+        winner = symbol;
+        finishRecord();
+    } else if (board.isFull()) {
         gameOver = true;
         winner = '.';
-        return true;
+        finishRecord();
+    } else {
+        turn = 1 - turn;
     }
-
-    switchTurn();
     return true;
 }
 
-bool GameController::isGameOver() const {
-    return gameOver;
+std::future<GameController::Reply> GameController::submitMove(int row, int col, ReplyCallback onReply,
+                                                              std::chrono::milliseconds limit) {
+    std::unique_lock<std::mutex> lock(mutex);
+    Reply reply;
+    if (thinking || aiToMove() || !placeLocked(row, col)) {
+        reply = snapshotLocked(Status::Rejected);
+    } else if (!gameOver && aiToMove()) {
+        return startSearchLocked(lock, std::move(onReply), limit);
+    } else {
+        reply = snapshotLocked(Status::Waiting);
+    }
+    lock.unlock();
+    return readyReply(reply, onReply);
 }
 
-char GameController::getWinnerSymbol() const {
-    return winner;
+std::future<GameController::Reply> GameController::requestAIMove(ReplyCallback onReply, std::chrono::milliseconds limit) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!thinking && !gameOver && aiToMove()) return startSearchLocked(lock, std::move(onReply), limit);
+    Reply reply = snapshotLocked(Status::Rejected);
+    lock.unlock();
+    return readyReply(reply, onReply);
+}
+
+void GameController::cancel() {
+    stopFlag = true;
 }
 
-void GameController::switchTurn() {
-    current = (current == p1) ? p2 : p1;
+// 在棋盤副本上搜尋，搜尋期間不持有 mutex，查詢棋盤與 cancel() 都不會被擋住
+std::future<GameController::Reply> GameController::startSearchLocked(std::unique_lock<std::mutex>& lock,
+                                                                     ReplyCallback onReply,
+                                                                     std::chrono::milliseconds limit) {
+    AIPlayer* ai = aiToMove();
+    auto promise = std::make_shared<std::promise<Reply>>();
+    std::future<Reply> future = promise->get_future();
+
+    thinking = true;
+    stopFlag = false;
+    ai->setTimeLimit(limit.count() > 0 ? limit : timeLimit);
+    Board position = board;
+    lock.unlock();
 
-    // AI 自動下棋
-    if (!gameOver && dynamic_cast<AIPlayer*>(current)) {
-        int row, col;
-        current->makeMove(board, row, col);
-        board.placePiece(row, col, current->getSymbol());
+    executor->submit([this, ai, position, promise, onReply]() mutable {
+        SearchResult result = ai->analyze(position);
 
-        if (board.isWin(row, col, current->getSymbol())) {
-            gameOver = true;
-            winner = current->getSymbol();
-        } else if (board.isFull()) {
-            gameOver = true;
-            winner = '.';
-        } else {
-            current = (current == p1) ? p2 : p1;
+        Reply reply;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (stopFlag) {
+                reply = snapshotLocked(Status::Cancelled);
+            } else if (result.move.first < 0) {
+                reply = snapshotLocked(Status::Error);
+                reply.error = "no legal move";
+            } else if (!placeLocked(result.move.first, result.move.second)) {
+                reply = snapshotLocked(Status::Error);
+                reply.error = "engine played an illegal move (" + std::to_string(result.move.first) + ", " +
+                              std::to_string(result.move.second) + ")";
+            } else {
+                reply = snapshotLocked(Status::Played);
+                reply.move = result.move;
+            }
+            reply.search = result;
+            thinking = false;
+            idle.notify_all(); // 持有鎖時通知：解構函式醒來前這裡已不再碰 this
         }
+        promise->set_value(reply);
+        if (onReply) onReply(reply);
+    });
+    return future;
+}
+
+bool GameController::makeMove(int row, int col) {
+    return submitMove(row, col).get().status != Status::Rejected;
+}
+
+bool GameController::setRecordFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!recorder.open(path)) return false;
+
+    GameRecord info;
+    info.boardSize = Board::SIZE;
+    info.rule = ActiveRule::id;
+    info.black = "Human";
+    auto* ai = dynamic_cast<AIPlayer*>(players[1].get());
+    info.white = ai ? "AI" : "Human";
+    if (ai) {
+        info.timePerMoveMs = static_cast<uint32_t>(timeLimit.count());
+        info.searchDepth = static_cast<uint8_t>(ai->getDepth());
+    }
+    recorder.beginGame(info);
+    return true;
+}
+
+bool GameController::setTableFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* ai = dynamic_cast<AIPlayer*>(players[1].get());
+    if (!ai || thinking) return false;
+    if (!ai->setTableFile(path)) {
+        std::cerr << path << ": not a table file for this AI, keeping the table in memory\n";
+        return false;
     }
+    return true;
+}
+
+void GameController::finishRecord() {
+    if (winner == 'X') recorder.endGame(RecordResult::BlackWin);
+    else if (winner == 'O') recorder.endGame(RecordResult::WhiteWin);
+    else recorder.endGame(RecordResult::Draw);
 }
@@ -0,0 +1,297 @@
+#include "GameRecord.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+
+static const char RECORD_MAGIC[8] = {'G', 'M', 'K', 'R', 'E', 'C', '1', '\0'};
+static const size_t GAME_HEADER_SIZE = 17; // 到名稱之前的固定欄位
+
+static int moveWidth(int boardSize) {
+    return boardSize * boardSize < 256 ? 1 : 2;
+}
+
+// --- 寫入 --- //
+
+GameRecordWriter::~GameRecordWriter() {
+    close();
+}
+
+bool GameRecordWriter::open(const std::string& path) {
+    close();
+    out = std::fopen(path.c_str(), "r+b");
+    if (!out) out = std::fopen(path.c_str(), "w+b");
+    if (!out) return false;
+
+    // 空檔案先寫魔術字
+    std::fseek(out, 0, SEEK_END);
+    const long size = std::ftell(out);
+    if (size == 0) {
+        std::fwrite(RECORD_MAGIC, 1, sizeof(RECORD_MAGIC), out);
+        end = sizeof(RECORD_MAGIC);
+        return std::fflush(out) == 0;
+    }
+
+    char magic[sizeof(RECORD_MAGIC)];
+    std::fseek(out, 0, SEEK_SET);
+    if (std::fread(magic, 1, sizeof(magic), out) != sizeof(magic) || std::memcmp(magic, RECORD_MAGIC, sizeof(magic)) != 0) {
+        close(); // 不是棋譜檔，不動它
+        return false;
+    }
+
+    // 只看每筆的長度欄位走到最後一筆完整紀錄；之後是上次當掉時寫到一半的資料，截掉
+    end = sizeof(RECORD_MAGIC);
+    unsigned char length[4];
+    while (end + static_cast<long>(GAME_HEADER_SIZE) <= size && std::fseek(out, end, SEEK_SET) == 0 &&
+           std::fread(length, 1, 4, out) == 4) {
+        uint32_t total = length[0] | (length[1] << 8) | (length[2] << 16) | (uint32_t(length[3]) << 24);
+        if (total < GAME_HEADER_SIZE || total > static_cast<uint32_t>(size - end)) break;
+        end += total;
+    }
+    if (end < size) {
+        std::fclose(out);
+        std::error_code ec;
+        std::filesystem::resize_file(path, static_cast<uintmax_t>(end), ec);
+        out = std::fopen(path.c_str(), "r+b");
+        if (ec || !out) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void GameRecordWriter::close() {
+    if (out) std::fclose(out);
+    out = nullptr;
+    inGame = false;
+    gameStart = -1;
+}
+
+void GameRecordWriter::beginGame(const GameRecord& info) {
+    current = info;
+    current.moves.clear();
+    current.result = RecordResult::Unknown;
+    inGame = true;
+    gameStart = -1;
+}
+
+bool GameRecordWriter::addMove(int row, int col) {
+    if (!inGame) return false;
+    if (current.moves.size() >= 65535) return false; // 步數欄位只有 16 位元
+    current.moves.emplace_back(row, col);
+    // 第一步寫出整筆紀錄，之後只在尾端追加這一步，再改標頭的長度與步數
+    if (gameStart < 0) {
+        gameStart = end;
+        return writeAt(gameStart, current);
+    }
+    unsigned char buf[2];
+    const int width = moveWidth(current.boardSize);
+    const uint32_t cell = row * current.boardSize + col;
+    buf[0] = static_cast<unsigned char>(cell & 0xFF);
+    buf[1] = static_cast<unsigned char>(cell >> 8);
+    if (std::fseek(out, end, SEEK_SET) != 0 || std::fwrite(buf, 1, width, out) != static_cast<size_t>(width)) return false;
+    // 當掉時若標頭還沒改到，長度欄位仍是舊的，open 會把多出來的這一步截掉
+    end += width;
+    return patchHeader();
+}
+
+bool GameRecordWriter::endGame(RecordResult result) {
+    if (!inGame) return false;
+    inGame = false;
+    current.result = result;
+    bool ok;
+    if (gameStart < 0) {
+        ok = writeAt(end, current); // 一步都沒下過
+    } else {
+        ok = patchHeader();
+    }
+    gameStart = -1;
+    return ok;
+}
+
+bool GameRecordWriter::write(const GameRecord& game) {
+    return writeAt(end, game);
+}
+
+bool GameRecordWriter::patchHeader() {
+    // 只改長度、大小、結果、規則、旗標與步數這 10 bytes，名稱與走法不動
+    const uint32_t total = static_cast<uint32_t>(end - gameStart);
+    const uint32_t count = static_cast<uint32_t>(current.moves.size());
+    unsigned char buf[10] = {
+        static_cast<unsigned char>(total & 0xFF), static_cast<unsigned char>((total >> 8) & 0xFF),
+        static_cast<unsigned char>((total >> 16) & 0xFF), static_cast<unsigned char>(total >> 24),
+        static_cast<unsigned char>(current.boardSize), static_cast<unsigned char>(current.result), current.rule,
+        static_cast<unsigned char>(moveWidth(current.boardSize) == 2 ? 1 : 0),
+        static_cast<unsigned char>(count & 0xFF), static_cast<unsigned char>(count >> 8),
+    };
+    if (std::fseek(out, gameStart, SEEK_SET) != 0) return false;
+    bool ok = std::fwrite(buf, 1, sizeof(buf), out) == sizeof(buf);
+    return std::fflush(out) == 0 && ok;
+}
+
+bool GameRecordWriter::writeAt(long pos, const GameRecord& game) {
+    if (!out) return false;
+
+    const int width = moveWidth(game.boardSize);
+    const size_t blackLen = std::min<size_t>(game.black.size(), 255);
+    const size_t whiteLen = std::min<size_t>(game.white.size(), 255);
+    const size_t moveCount = std::min<size_t>(game.moves.size(), 65535);
+    const size_t total = GAME_HEADER_SIZE + blackLen + whiteLen + moveCount * width;
+
+    std::vector<unsigned char> buf;
+    buf.reserve(total);
+    auto put8 = [&](uint32_t v) { buf.push_back(static_cast<unsigned char>(v)); };
+    auto put16 = [&](uint32_t v) { put8(v & 0xFF); put8((v >> 8) & 0xFF); };
+    auto put32 = [&](uint32_t v) { put16(v & 0xFFFF); put16(v >> 16); };
+
+    put32(static_cast<uint32_t>(total));
+    put8(game.boardSize);
+    put8(static_cast<uint8_t>(game.result));
+    put8(game.rule);
+    put8(width == 2 ? 1 : 0);
+    put16(static_cast<uint32_t>(moveCount));
+    put32(game.timePerMoveMs);
+    put8(game.searchDepth);
+    put8(static_cast<uint32_t>(blackLen));
+    put8(static_cast<uint32_t>(whiteLen));
+    buf.insert(buf.end(), game.black.begin(), game.black.begin() + blackLen);
+    buf.insert(buf.end(), game.white.begin(), game.white.begin() + whiteLen);
+    for (size_t i = 0; i < moveCount; ++i) {
+        uint32_t cell = game.moves[i].first * game.boardSize + game.moves[i].second;
+        if (width == 1) put8(cell);
+        else put16(cell);
+    }
+
+    if (std::fseek(out, pos, SEEK_SET) != 0) return false;
+    bool ok = std::fwrite(buf.data(), 1, buf.size(), out) == buf.size();
+    if (std::fflush(out) != 0 || !ok) return false;
+    end = pos + static_cast<long>(buf.size());
+    return true;
+}
+
+// --- 讀取 --- //
+
+bool GameRecordReader::open(const std::string& path) {
+    if (!file.openRead(path) || file.size() < HEADER_SIZE ||
+        std::memcmp(file.data(), RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0) {
+        file.close();
+        return false;
+    }
+    rewind();
+    return true;
+}
+
+bool GameRecordReader::viewAt(size_t pos, GameView& game) const {
+    if (pos + GAME_HEADER_SIZE > file.size()) return false;
+    const unsigned char* p = file.data() + pos;
+    uint32_t total = p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+    if (total < GAME_HEADER_SIZE || total > file.size() - pos) return false; // 截斷的最後一盤
+
+    // 長度欄位以外的內容也要一致，move() / black() / white() 才不會讀出界
+    const int size = p[4];
+    if (size != 15 && size != 19) return false;
+    const int width = (p[7] & 1) ? 2 : 1;
+    const size_t count = p[8] | (p[9] << 8);
+    if (width != moveWidth(size) || total != GAME_HEADER_SIZE + p[15] + p[16] + count * width) return false;
+    const unsigned char* moves = p + GAME_HEADER_SIZE + p[15] + p[16];
+    for (size_t i = 0; i < count; ++i) {
+        int cell = width == 2 ? (moves[2 * i] | (moves[2 * i + 1] << 8)) : moves[i];
+        if (cell >= size * size) return false;
+    }
+
+    game.data = p;
+    game.moves = moves;
+    return true;
+}
+
+bool GameRecordReader::next(GameView& game) {
+    if (!viewAt(offset, game)) return false;
+    offset += game.data[0] | (game.data[1] << 8) | (game.data[2] << 16) | (uint32_t(game.data[3]) << 24);
+    return true;
+}
+
+std::pair<int, int> GameRecordReader::GameView::move(int i) const {
+    int size = boardSize();
+    int cell = (data[7] & 1) ? (moves[2 * i] | (moves[2 * i + 1] << 8)) : moves[i];
+    return {cell / size, cell % size};
+}
+
+GameRecord GameRecordReader::GameView::toRecord() const {
+    GameRecord game;
+    game.boardSize = boardSize();
+    game.result = result();
+    game.rule = rule();
+    game.timePerMoveMs = timePerMoveMs();
+    game.searchDepth = searchDepth();
+    game.black = black();
+    game.white = white();
+    for (int i = 0; i < moveCount(); ++i) game.moves.push_back(move(i));
+    return game;
+}
+
+// --- 文字格式 --- //
+
+std::string formatMoveText(const GameRecord& game) {
+    std::string text;
+    for (auto [r, c] : game.moves) {
+        if (!text.empty()) text += ' ';
+        text += static_cast<char>('a' + c);
+        text += std::to_string(game.boardSize - r);
+    }
+    return text;
+}
+
+bool parseMoveText(const std::string& text, int boardSize, std::vector<std::pair<int, int>>& moves) {
+    moves.clear();
+    std::istringstream in(text);
+    std::string token;
+    while (in >> token) {
+        if (token.size() < 2 || !std::isalpha(static_cast<unsigned char>(token[0]))) return false;
+        int col = std::tolower(static_cast<unsigned char>(token[0])) - 'a';
+        int rank = 0;
+        for (size_t i = 1; i < token.size(); ++i) {
+            if (!std::isdigit(static_cast<unsigned char>(token[i]))) return false;
+            rank = rank * 10 + (token[i] - '0');
+        }
+        int row = boardSize - rank;
+        if (row < 0 || row >= boardSize || col < 0 || col >= boardSize) return false;
+        moves.emplace_back(row, col);
+    }
+    return true;
+}
+
+std::string formatPsq(const GameRecord& game) {
+    std::ostringstream out;
+    out << "Piskvorky " << game.boardSize << "x" << game.boardSize << ", 11:11, 0\n";
+    for (auto [r, c] : game.moves) out << (c + 1) << "," << (r + 1) << "," << game.timePerMoveMs << "\n";
+    out << "-1\n";
+    if (!game.black.empty()) out << game.black << "\n";
+    if (!game.white.empty()) out << game.white << "\n";
+    return out.str();
+}
+
+bool parsePsq(const std::string& text, GameRecord& game) {
+    std::istringstream in(text);
+    std::string line;
+    if (!std::getline(in, line)) return false;
+
+    int width = 0, height = 0;
+    auto space = line.find(' ');
+    if (space == std::string::npos || std::sscanf(line.c_str() + space + 1, "%dx%d", &width, &height) != 2 ||
+        width != height) {
+        return false;
+    }
+    game = GameRecord();
+    game.boardSize = width;
+
+    // 走法行之後的內容（引擎名稱等）直接略過
+    while (std::getline(in, line)) {
+        int x, y, t;
+        if (std::sscanf(line.c_str(), "%d,%d,%d", &x, &y, &t) != 3) break;
+        if (x < 1 || x > width || y < 1 || y > width) return false;
+        game.moves.emplace_back(y - 1, x - 1);
+    }
+    return true;
+}
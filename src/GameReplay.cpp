@@ -0,0 +1,193 @@
+#include "GameReplay.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+// --- GameReplay --- //
+
+template <int N>
+bool GameReplay<N>::load(const std::vector<std::pair<int, int>>& game, uint8_t rule) {
+    ruleId = rule;
+    moves.clear();
+    keyframes.clear();
+    current = BoardType();
+    hash = 0;
+    at = 0;
+
+    // 從頭走一遍：驗證每一步，同時留下關鍵盤面
+    BoardType board;
+    uint64_t h = 0;
+    keyframes.push_back({board, h});
+    bool ok = true;
+    for (auto [r, c] : game) {
+        const char symbol = symbolAt(length());
+        if (!board.placePiece(r, c, symbol)) {
+            ok = false;
+            break;
+        }
+        h ^= zobristKeys<N>(r, c, symbol);
+        moves.emplace_back(r, c);
+        if (length() % KEYFRAME_INTERVAL == 0) keyframes.push_back({board, h});
+    }
+    return ok;
+}
+
+template <int N>
+void GameReplay<N>::seek(int ply) {
+    ply = std::clamp(ply, 0, length());
+    const int fromKeyframe = ply % KEYFRAME_INTERVAL;
+    if (std::abs(ply - at) > fromKeyframe) {
+        const Keyframe& k = keyframes[ply / KEYFRAME_INTERVAL];
+        current = k.board;
+        hash = k.hash;
+        at = ply - fromKeyframe;
+    }
+    for (; at < ply; ++at) {
+        auto [r, c] = moves[at];
+        current.placePiece(r, c, symbolAt(at));
+        hash ^= zobristKeys<N>(r, c, symbolAt(at));
+    }
+    while (at > ply) {
+        --at;
+        auto [r, c] = moves[at];
+        current.removePiece(r, c);
+        hash ^= zobristKeys<N>(r, c, symbolAt(at));
+    }
+}
+
+template <int N>
+typename GameReplay<N>::BoardType GameReplay<N>::boardAt(int ply, uint64_t& key) const {
+    ply = std::clamp(ply, 0, length());
+    const Keyframe& k = keyframes[ply / KEYFRAME_INTERVAL];
+    BoardType board = k.board;
+    key = k.hash;
+    for (int i = ply - ply % KEYFRAME_INTERVAL; i < ply; ++i) {
+        auto [r, c] = moves[i];
+        board.placePiece(r, c, symbolAt(i));
+        key ^= zobristKeys<N>(r, c, symbolAt(i));
+    }
+    return board;
+}
+
+template <int N>
+char GameReplay<N>::winner() const {
+    if (at == 0) return '.';
+    auto [r, c] = moves[at - 1];
+    return isWin(ruleId, current, r, c, symbolAt(at - 1)) ? symbolAt(at - 1) : '.';
+}
+
+template <int N>
+bool GameReplay<N>::isWin(uint8_t rule, const BoardType& board, int row, int col, char symbol) {
+    switch (rule) {
+        case StandardRule::id: return StandardRule::isWin(board, row, col, symbol);
+        case RenjuRule::id: return RenjuRule::isWin(board, row, col, symbol);
+        default: return FreestyleRule::isWin(board, row, col, symbol);
+    }
+}
+
+// --- ReplayAnalyzer --- //
+
+template <int N>
+ReplayAnalyzer<N>::ReplayAnalyzer(int depth, std::chrono::milliseconds timeLimit)
+    : depth(depth), timeLimit(timeLimit) {
+    worker = std::thread([this]() { loop(); });
+}
+
+template <int N>
+ReplayAnalyzer<N>::~ReplayAnalyzer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+        queue.clear();
+    }
+    stop = true;
+    wake.notify_all();
+    worker.join();
+}
+
+template <int N>
+void ReplayAnalyzer<N>::request(const GameReplay<N>& replay, int prefetch) {
+    // 目前這一手、下一手、上一手、下兩手……往後瀏覽比往前常見，同距離時先排後面
+    std::vector<int> plies = {replay.ply()};
+    for (int d = 1; d <= prefetch; ++d) {
+        plies.push_back(replay.ply() + d);
+        plies.push_back(replay.ply() - d);
+    }
+
+    std::deque<Job> jobs;
+    for (int ply : plies) {
+        if (ply < 0 || ply > replay.length()) continue;
+        Job job;
+        job.board = replay.boardAt(ply, job.key);
+        job.side = GameReplay<N>::symbolAt(ply);
+        if (job.board.isFull()) continue;
+        if (ply > 0) { // 已經分出勝負的局面不必分析
+            auto [r, c] = replay.moveAt(ply - 1);
+            if (GameReplay<N>::isWin(replay.rule(), job.board, r, c, GameReplay<N>::symbolAt(ply - 1))) continue;
+        }
+        jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.clear();
+        for (Job& job : jobs)
+            if (!cache.count(job.key)) queue.push_back(std::move(job));
+        // 目前這一手還沒有結果，而工作執行緒在算別的局面：中止它
+        if (running && !queue.empty() && queue.front().key == replay.key() && runningKey != replay.key()) stop = true;
+    }
+    wake.notify_all();
+}
+
+template <int N>
+bool ReplayAnalyzer<N>::lookup(uint64_t key, SearchResult& result) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(key);
+    if (it == cache.end()) return false;
+    result = it->second;
+    return true;
+}
+
+template <int N>
+size_t ReplayAnalyzer<N>::cachedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.size();
+}
+
+template <int N>
+void ReplayAnalyzer<N>::loop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return quit || !queue.empty(); });
+            if (quit) return;
+            job = std::move(queue.front());
+            queue.pop_front();
+            if (cache.count(job.key)) continue;
+            running = true;
+            runningKey = job.key;
+            stop = false;
+        }
+
+        auto& engine = engines[job.side == 'X' ? 0 : 1];
+        if (!engine) {
+            engine.reset(new SearchEngine<N>(job.side));
+            engine->setDepth(depth);
+            engine->setTimeLimit(timeLimit);
+            engine->setThreads(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1)); // 留一個核心給畫面
+            engine->setStopFlag(&stop);
+        }
+        SearchResult result = engine->analyze(job.board);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        if (stop) continue; // 被中止的結果不完整，不存
+        if (cache.size() >= MAX_CACHED) cache.clear();
+        cache[job.key] = std::move(result);
+    }
+}
+
+template class GameReplay<15>;
+template class GameReplay<19>;
+template class ReplayAnalyzer<15>;
+template class ReplayAnalyzer<19>;
@@ -1,26 +1,36 @@
 #include "GameWindow.hpp"
-#include "HumanPlayer.hpp"
-#include "AIPlayer.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cmath>  // 引入 <cmath> 库以使用 sin 函数
+#include <cstdio>
+#include <string>
+#include <tuple>
 
-GameWindow::GameWindow(std::unique_ptr<Player> p1, std::unique_ptr<Player> p2, bool isPvP)
-    : p1(std::move(p1)), p2(std::move(p2)), isPvP(isPvP), gameOver(false) {
-    currentPlayer = this->p1.get();
+GameWindow::GameWindow(bool isPvP, FrameStats* frameStats)
+    : isPvP(isPvP), gameOver(false), frameStats(frameStats) {
     lastPlayerSymbol = ' ';  // 初始化最後下棋的玩家符號
     lastMoveRow = -1;        // 初始化最後下棋的行
     lastMoveCol = -1;        // 初始化最後下棋的列
 }
 
+GameWindow::~GameWindow() {
+    stopAnalysis();
+}
+
 GameResult GameWindow::run(sf::RenderWindow& window, sf::Font& font) {
     wantToRestart = false;
     wantToExit = false;
     wantToModeSelection = false;
-    gameOver = false;
-    currentPlayer = p1.get();
-    board = Board();  // 重置棋盤
     justRestarted = true;
 
+    // 新的一盤：棋盤重置，棋譜追加到 games.gmr，AI 的置換表接續 ai.tt
+    aiReply = std::future<GameController::Reply>();
+    controller = std::make_unique<GameController>(!isPvP);
+    controller->setRecordFile("games.gmr");
+    if (!isPvP) controller->setTableFile("ai.tt");
+    syncFromController();
+    startAnalysis();
+
     // 回合文字顯示
     sf::Text turnText;
     turnText.setFont(font);
@@ -28,9 +38,16 @@ GameResult GameWindow::run(sf::RenderWindow& window, sf::Font& font) {
     turnText.setFillColor(sf::Color::Black);
     turnText.setPosition(10, 630);
 
+    auto endPhase = [this](FrameStats::Phase phase) {
+        if (frameStats) frameStats->endPhase(phase);
+    };
+
     while (window.isOpen() && !wantToRestart && !wantToExit && !wantToModeSelection) {
+        if (frameStats) frameStats->beginFrame();
         handleEvents(window);
+        endPhase(FrameStats::EVENTS);
         update();
+        endPhase(FrameStats::UPDATE);
 
         window.clear(sf::Color::White);
         draw(window, font);
@@ -39,22 +56,31 @@ GameResult GameWindow::run(sf::RenderWindow& window, sf::Font& font) {
         if (gameOver) {
             turnText.setString("");
         } else {
-            if (currentPlayer->getSymbol() == 'X') {
+            if (currentPlayerSymbol == 'X') {
                 turnText.setString("Player 1's Turn (Black)");
-            } else if (currentPlayer->getSymbol() == 'O') {
+            } else if (aiReply.valid()) {
+                turnText.setString("Player 2's Turn (White) - thinking...");
+            } else {
                 turnText.setString("Player 2's Turn (White)");
             }
         }
 
-        window.draw(turnText);
+        drawItem(window, turnText);
+        endPhase(FrameStats::DRAW);
 
         if (gameOver) {
             displayResult(window, font);
         }
+        endPhase(FrameStats::RESULT);
+
+        if (frameStats && frameStats->overlayVisible()) drawFrameStats(window, font);
+        endPhase(FrameStats::OVERLAY);
 
         window.display();
+        if (frameStats) frameStats->endFrame();
     }
 
+    stopAnalysis();
     if (wantToModeSelection) return GameResult::ReturnToMenu;
     if (wantToRestart) return GameResult::Restart;
     return GameResult::Exit;
@@ -76,6 +102,14 @@ void GameWindow::handleEvents(sf::RenderWindow& window) {
             return;
         }
 
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::H) {
+            showHeatmap = !showHeatmap;
+            if (showHeatmap) startAnalysis();
+            else stopAnalysis();
+        }
+
+        handleFrameStatsKey(event);
+
         if (event.type == sf::Event::MouseButtonPressed) {
             sf::Vector2f worldPos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
 
@@ -98,45 +132,90 @@ void GameWindow::handleEvents(sf::RenderWindow& window) {
                     return;
                 }
 
-            } else if (currentPlayer == p1.get() || currentPlayer == p2.get()) {
+            } else if (!aiReply.valid()) { // AI 思考中不接受點擊
                 int col = static_cast<int>(worldPos.x) / CELL_SIZE;
                 int row = static_cast<int>(worldPos.y) / CELL_SIZE;
 
+                // 禁手、有子的格子由 controller 拒絕
                 if (row >= 0 && row < Board::SIZE && col >= 0 && col < Board::SIZE) {
-                    if (board.placePiece(row, col, currentPlayer->getSymbol())) {
-                        lastMoveRow = row;
-                        lastMoveCol = col;
-                        lastPlayerSymbol = currentPlayer->getSymbol();
-
-                        if (board.isWin(row, col, currentPlayer->getSymbol()) || board.isFull()) {
-                            gameOver = true;
-                        } else {
-                            currentPlayer = (currentPlayer == p1.get()) ? p2.get() : p1.get();
-                        }
+                    stopAnalysis(); // 接下來可能輪到 AI，先讓出 CPU
+                    auto reply = controller->submitMove(row, col);
+                    if (reply.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                        aiReply = std::move(reply); // AI 開始搜尋，結果由 update() 取回
+                    } else if (reply.get().status == GameController::Status::Rejected) {
+                        startAnalysis();
+                        continue;
                     }
+                    syncFromController();
+                    startAnalysis();
                 }
             }
         }
     }
 }
 void GameWindow::update() {
-    if (gameOver || isPvP) return;
-
-    if (currentPlayer == p2.get()) {
-        int row, col;
-        currentPlayer->makeMove(board, row, col);
-        if (board.placePiece(row, col, currentPlayer->getSymbol())) {
-            lastMoveRow = row;
-            lastMoveCol = col;
-            lastPlayerSymbol = currentPlayer->getSymbol();
-
-            if (board.isWin(row, col, currentPlayer->getSymbol()) || board.isFull()) {
-                gameOver = true;
-            } else {
-                currentPlayer = p1.get();
-            }
-        }
+    // AI 在 controller 的工作執行緒上搜尋，這裡只看結果好了沒，思考中畫面照常更新
+    if (!aiReply.valid() || aiReply.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+    GameController::Reply reply = aiReply.get();
+    if (reply.status == GameController::Status::Error) std::cerr << "AI: " << reply.error << "\n";
+    syncFromController();
+    startAnalysis();
+}
+
+
+void GameWindow::syncFromController() {
+    board = controller->getBoard();
+    currentPlayerSymbol = controller->getCurrentSymbol();
+    gameOver = controller->isGameOver();
+    auto history = controller->getHistory();
+    if (!history.empty()) {
+        std::tie(lastMoveRow, lastMoveCol) = history.back();
+        lastPlayerSymbol = history.size() % 2 ? 'X' : 'O';
+    } else {
+        lastMoveRow = lastMoveCol = -1;
+        lastPlayerSymbol = ' ';
+    }
+}
+
+
+void GameWindow::startAnalysis() {
+    stopAnalysis();
+    {
+        std::lock_guard<std::mutex> lock(analysisMutex);
+        analysisLines.clear();
+        analysisDepth = -1;
+    }
+    if (!showHeatmap || gameOver) return;
+    // 輪到 AI 時分析等它下完再開始
+    if (!isPvP && currentPlayerSymbol == 'O') return;
+
+    char side = currentPlayerSymbol;
+    auto& engine = analysisEngines[side == 'X' ? 0 : 1];
+    if (!engine) {
+        engine.reset(new SearchEngine<Board::SIZE>(side));
+        engine->setDepth(6);
+        engine->setTimeLimit(std::chrono::seconds(30));
+        engine->setThreads(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1)); // 留一個核心給畫面
+        engine->setStopFlag(&analysisStop);
     }
+
+    analysisStop = false;
+    Board snapshot = board;
+    SearchEngine<Board::SIZE>* e = engine.get();
+    analysisThread = std::thread([this, e, snapshot]() mutable {
+        e->analyzeMultiPV(snapshot, HEATMAP_LINES, [this](const std::vector<SearchResult>& lines, int depth) {
+            std::lock_guard<std::mutex> lock(analysisMutex);
+            analysisLines = lines;
+            analysisDepth = depth;
+        });
+    });
+}
+
+
+void GameWindow::stopAnalysis() {
+    if (!analysisThread.joinable()) return;
+    analysisStop = true;
+    analysisThread.join();
 }
 
 
@@ -148,14 +227,21 @@ void GameWindow::draw(sf::RenderWindow& window, sf::Font& font) {
     infoText.setFont(font);
     infoText.setCharacterSize(18);
     infoText.setFillColor(sf::Color::Black);
-    infoText.setString("Player 1: Black (X)    Player 2: White (O)");
+    infoText.setString("Player 1: Black (X)    Player 2: White (O)    H: heatmap");
     infoText.setPosition(10, 600);  // 棋盤下方
 
 
-    window.draw(infoText);
+    drawItem(window, infoText);
 
 
     // 🧱 繪製棋盤格與棋子（維持原本位置）
+    drawBoard(window);
+
+    if (showHeatmap) drawHeatmap(window, font);
+}
+
+
+void GameWindow::drawBoard(sf::RenderWindow& window) {
     sf::RectangleShape cell(sf::Vector2f(CELL_SIZE - 2, CELL_SIZE - 2));
     for (int i = 0; i < Board::SIZE; ++i) {
         for (int j = 0; j < Board::SIZE; ++j) {
@@ -163,7 +249,7 @@ void GameWindow::draw(sf::RenderWindow& window, sf::Font& font) {
             cell.setFillColor(sf::Color(245, 222, 179));
             cell.setOutlineThickness(1);
             cell.setOutlineColor(sf::Color(160, 82, 45));
-            window.draw(cell);
+            drawItem(window, cell);
 
             char val = board.getCell(i, j);
             if (val == 'X' || val == 'O') {
@@ -172,13 +258,127 @@ void GameWindow::draw(sf::RenderWindow& window, sf::Font& font) {
                 piece.setFillColor(val == 'X' ? sf::Color::Black : sf::Color::White);
                 piece.setOutlineThickness(2);
                 piece.setOutlineColor(sf::Color::Black);
-                window.draw(piece);
+                drawItem(window, piece);
             }
         }
     }
 }
 
 
+// 前幾名候選步依名次上色（越紅越好），標上分數；第一名的主要變化以序號標出
+void GameWindow::drawHeatmap(sf::RenderWindow& window, sf::Font& font) {
+    std::vector<SearchResult> lines;
+    int depth;
+    {
+        std::lock_guard<std::mutex> lock(analysisMutex);
+        lines = analysisLines;
+        depth = analysisDepth;
+    }
+
+    sf::Text label;
+    label.setFont(font);
+    label.setCharacterSize(11);
+    label.setFillColor(sf::Color::Black);
+
+    for (size_t rank = 0; rank < lines.size(); ++rank) {
+        auto [r, c] = lines[rank].move;
+        float strength = 1.f - static_cast<float>(rank) / HEATMAP_LINES;
+        sf::RectangleShape heat(sf::Vector2f(CELL_SIZE - 2, CELL_SIZE - 2));
+        heat.setPosition(c * CELL_SIZE + 1, r * CELL_SIZE + 1);
+        heat.setFillColor(sf::Color(255, static_cast<sf::Uint8>(200 * (1.f - strength)), 0, static_cast<sf::Uint8>(60 + 140 * strength)));
+        drawItem(window, heat);
+
+        label.setString(std::to_string(lines[rank].score));
+        label.setPosition(c * CELL_SIZE + 3, r * CELL_SIZE + 3);
+        drawItem(window, label);
+    }
+
+    if (!lines.empty()) {
+        const auto& pv = lines[0].pv;
+        for (size_t i = 1; i < pv.size(); ++i) {
+            auto [r, c] = pv[i];
+            sf::CircleShape ghost(CELL_SIZE / 2 - 10);
+            ghost.setPosition(c * CELL_SIZE + 10, r * CELL_SIZE + 10);
+            ghost.setFillColor(i % 2 ? sf::Color(255, 255, 255, 120) : sf::Color(0, 0, 0, 120));
+            drawItem(window, ghost);
+
+            label.setString(std::to_string(i + 1));
+            label.setPosition(c * CELL_SIZE + CELL_SIZE / 2 - 4, r * CELL_SIZE + CELL_SIZE / 2 - 7);
+            drawItem(window, label);
+        }
+    }
+
+    sf::Text status;
+    status.setFont(font);
+    status.setCharacterSize(14);
+    status.setFillColor(sf::Color::Black);
+    status.setString(depth < 0 ? "Analysis: thinking..." : "Analysis depth " + std::to_string(depth));
+    status.setPosition(420, 630);
+    drawItem(window, status);
+}
+
+
+void GameWindow::handleFrameStatsKey(const sf::Event& event) {
+    if (event.type != sf::Event::KeyPressed || !frameStats) return;
+    if (event.key.code == sf::Keyboard::F3) frameStats->setOverlayVisible(!frameStats->overlayVisible());
+    if (event.key.code == sf::Keyboard::F4) {
+        frameStats->setLogEnabled(!frameStats->logEnabled());
+        std::cerr << "Frame log " << (frameStats->logEnabled() ? "on" : "off") << "\n";
+    }
+}
+
+
+void GameWindow::drawItem(sf::RenderWindow& window, const sf::Drawable& item) {
+    window.draw(item);
+    if (frameStats) frameStats->countDraw();
+}
+
+
+// 右上角的計時面板：最近幾幀的 FPS、各階段平均 / 最大、draw 呼叫與掉幀，下方是幀時間分布
+void GameWindow::drawFrameStats(sf::RenderWindow& window, sf::Font& font) {
+    const FrameStats::Summary s = frameStats->recent();
+    const float x = 372.f, y = 4.f, width = 224.f;
+
+    char line[96];
+    std::string text;
+    std::snprintf(line, sizeof(line), "FPS %.1f  frame %.1f / %.1f ms\n", s.avgMs > 0 ? 1000.0 / s.avgMs : 0.0, s.avgMs,
+                  s.maxMs);
+    text += line;
+    for (int p = 0; p < FrameStats::PHASE_COUNT; ++p) {
+        std::snprintf(line, sizeof(line), "  %-8s %7.2f / %7.2f ms\n", FrameStats::PHASE_NAMES[p], s.phaseAvgMs[p],
+                      s.phaseMaxMs[p]);
+        text += line;
+    }
+    std::snprintf(line, sizeof(line), "draws %.0f  dropped %d (total %llu)\n", s.avgDrawCalls, s.dropped,
+                  static_cast<unsigned long long>(frameStats->droppedTotal()));
+    text += line;
+    text += "frame time: 4 8 12 17 20 33 50 100 ms";
+
+    const float barTop = y + 150.f, barHeight = 40.f;
+    sf::RectangleShape panel(sf::Vector2f(width, barTop + barHeight + 6.f - y));
+    panel.setPosition(x, y);
+    panel.setFillColor(sf::Color(0, 0, 0, 170));
+    drawItem(window, panel);
+
+    sf::Text label(text, font, 11);
+    label.setFillColor(sf::Color::White);
+    label.setPosition(x + 6.f, y + 4.f);
+    drawItem(window, label);
+
+    // 超過一幀預算（17 ms 以上）的桶子畫成紅色
+    const float barWidth = (width - 12.f) / FrameStats::HISTOGRAM_BUCKETS;
+    const int budgetBucket = FrameStats::bucketOf(frameStats->budgetMs());
+    for (int b = 0; b < FrameStats::HISTOGRAM_BUCKETS; ++b) {
+        if (s.histogram[b] == 0) continue;
+        float h = std::max(1.f, barHeight * s.histogram[b] / std::max(1, s.frames));
+        sf::RectangleShape bar(sf::Vector2f(barWidth - 2.f, h));
+        bar.setPosition(x + 6.f + b * barWidth, barTop + barHeight - h);
+        bar.setFillColor(b > budgetBucket ? sf::Color(230, 60, 60) : sf::Color(90, 200, 90));
+        drawItem(window, bar);
+    }
+}
+
+
 void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
     // 滑鼠位置
     sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
@@ -200,9 +400,9 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
     float animScale = 1.f + 0.2f * sin(clock.getElapsedTime().asSeconds() * 2.f);  // 動畫效果：逐漸放大
 
     // 設定文字內容
-    if (board.isFull() && !board.isWin(lastMoveRow, lastMoveCol, lastPlayerSymbol)) {
+    if (board.isFull() && !ActiveRule::isWin(board, lastMoveRow, lastMoveCol, lastPlayerSymbol)) {
         resultText.setString("It's a draw!");
-    } else if (board.isWin(lastMoveRow, lastMoveCol, lastPlayerSymbol)) {
+    } else if (ActiveRule::isWin(board, lastMoveRow, lastMoveCol, lastPlayerSymbol)) {
         resultText.setString(lastPlayerSymbol == 'X' ? "Player 1 (X) wins!" : "Player 2 (O) wins!");
     }
 
@@ -224,21 +424,21 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
     resultBox.setOutlineThickness(3.f);
 
     // 畫出背景框與文字
-    window.draw(resultBox);
-    window.draw(resultText);
+    drawItem(window, resultBox);
+    drawItem(window, resultText);
 
     // ===== Restart 按鈕繪製 =====
     restartButton.setSize(sf::Vector2f(200, 50));
     restartButton.setPosition(220, 300);
     sf::Color restartColor(70, 130, 180, 255 - static_cast<int>(restartHoverAlpha));
     restartButton.setFillColor(restartColor);
-    window.draw(restartButton);
+    drawItem(window, restartButton);
 
     sf::RectangleShape restartOutline(restartButton);
     restartOutline.setFillColor(sf::Color::Transparent);
     restartOutline.setOutlineThickness(2);
     restartOutline.setOutlineColor(sf::Color::White);
-    window.draw(restartOutline);
+    drawItem(window, restartOutline);
 
     for (int i = 0; i < 4; ++i) {
         sf::CircleShape corner(10);
@@ -246,7 +446,7 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
         float x = (i % 2 == 0) ? restartButton.getPosition().x : restartButton.getPosition().x + restartButton.getSize().x - 20;
         float y = (i < 2) ? restartButton.getPosition().y : restartButton.getPosition().y + restartButton.getSize().y - 20;
         corner.setPosition(x, y);
-        window.draw(corner);
+        drawItem(window, corner);
     }
 
     restartText.setFont(font);
@@ -257,7 +457,7 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
         restartButton.getPosition().x + (200 - restartText.getLocalBounds().width) / 2,
         restartButton.getPosition().y + 10
     );
-    window.draw(restartText);
+    drawItem(window, restartText);
 
 
     // ===== Exit 按鈕繪製 =====
@@ -265,13 +465,13 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
     exitButton.setPosition(220, 380);
     sf::Color exitColor(220, 20, 60, 255 - static_cast<int>(exitHoverAlpha));
     exitButton.setFillColor(exitColor);
-    window.draw(exitButton);
+    drawItem(window, exitButton);
 
     sf::RectangleShape exitOutline(exitButton);
     exitOutline.setFillColor(sf::Color::Transparent);
     exitOutline.setOutlineThickness(2);
     exitOutline.setOutlineColor(sf::Color::White);
-    window.draw(exitOutline);
+    drawItem(window, exitOutline);
 
     for (int i = 0; i < 4; ++i) {
         sf::CircleShape corner(10);
@@ -279,7 +479,7 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
         float x = (i % 2 == 0) ? exitButton.getPosition().x : exitButton.getPosition().x + exitButton.getSize().x - 20;
         float y = (i < 2) ? exitButton.getPosition().y : exitButton.getPosition().y + exitButton.getSize().y - 20;
         corner.setPosition(x, y);
-        window.draw(corner);
+        drawItem(window, corner);
     }
 
     exitText.setFont(font);
@@ -290,12 +490,12 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
         exitButton.getPosition().x + (200 - exitText.getLocalBounds().width) / 2,
         exitButton.getPosition().y + 10
     );
-    window.draw(exitText);
+    drawItem(window, exitText);
     // 資訊欄背景
     sf::RectangleShape infoBar(sf::Vector2f(window.getSize().x, 40.f));
     infoBar.setFillColor(sf::Color(200, 200, 200));
     infoBar.setPosition(0, 0);
-    window.draw(infoBar);
+    drawItem(window, infoBar);
 
     // 顯示玩家資訊欄
     sf::Text infoText;
@@ -304,29 +504,29 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
     infoText.setFillColor(sf::Color::Black);
     infoText.setString("Player 1: Black (X)    Player 2: White (O)");
     infoText.setPosition(10, 10); // 上方 10px 的位置
-    window.draw(infoText);
+    drawItem(window, infoText);
 
     // 顯示玩家回合資訊
     sf::Text turnText;
     turnText.setFont(font);
     turnText.setCharacterSize(18);
-    turnText.setFillColor(currentPlayer->getSymbol() == 'X' ? sf::Color::Black : sf::Color::White);
-    turnText.setString(currentPlayer->getSymbol() == 'X' ? "Player 1's Turn (Black)" : "Player 2's Turn (White)");
+    turnText.setFillColor(currentPlayerSymbol == 'X' ? sf::Color::Black : sf::Color::White);
+    turnText.setString(currentPlayerSymbol == 'X' ? "Player 1's Turn (Black)" : "Player 2's Turn (White)");
     turnText.setPosition(10, 630);  // 設置顯示位置
-    window.draw(turnText);  // 顯示回合文字
+    drawItem(window, turnText);  // 顯示回合文字
 
      // ===== Game Mode 按鈕繪製 =====
     gameModeButton.setSize(sf::Vector2f(200, 50));
     gameModeButton.setPosition(220, 460);
     sf::Color gameModeColor(255, 165, 0, 255 - static_cast<int>(gameModeHoverAlpha));
     gameModeButton.setFillColor(gameModeColor);
-    window.draw(gameModeButton);
+    drawItem(window, gameModeButton);
 
     sf::RectangleShape gameModeOutline(gameModeButton);
     gameModeOutline.setFillColor(sf::Color::Transparent);
     gameModeOutline.setOutlineThickness(2);
     gameModeOutline.setOutlineColor(sf::Color::White);
-    window.draw(gameModeOutline);
+    drawItem(window, gameModeOutline);
 
     for (int i = 0; i < 4; ++i) {
         sf::CircleShape corner(10);
@@ -334,7 +534,7 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
         float x = (i % 2 == 0) ? gameModeButton.getPosition().x : gameModeButton.getPosition().x + gameModeButton.getSize().x - 20;
         float y = (i < 2) ? gameModeButton.getPosition().y : gameModeButton.getPosition().y + gameModeButton.getSize().y - 20;
         corner.setPosition(x, y);
-        window.draw(corner);
+        drawItem(window, corner);
     }
 
     gameModeText.setFont(font);
@@ -345,12 +545,227 @@ void GameWindow::displayResult(sf::RenderWindow& window, sf::Font& font) {
         gameModeButton.getPosition().x + (200 - gameModeText.getLocalBounds().width) / 2,
         gameModeButton.getPosition().y + 10
     );
-    window.draw(gameModeText);
+    drawItem(window, gameModeText);
     
 }
 
 
-bool GameWindow::showModeSelection(sf::RenderWindow& window, sf::Font& font, bool& isPvP) {
+// --- 棋譜重播 --- //
+
+// 進度列的位置（棋盤下方資訊欄）
+static const float REPLAY_BAR_X = 10.f, REPLAY_BAR_Y = 628.f, REPLAY_BAR_WIDTH = 380.f, REPLAY_BAR_HEIGHT = 10.f;
+
+// 與文字棋譜相同的座標記法，例如 "h8"
+static std::string moveName(std::pair<int, int> move) {
+    return static_cast<char>('a' + move.second) + std::to_string(Board::SIZE - move.first);
+}
+
+
+GameResult GameWindow::runReplay(sf::RenderWindow& window, sf::Font& font, const std::string& path) {
+    wantToExit = false;
+    wantToModeSelection = false;
+    replayGames.clear();
+    replayAllFound = false;
+    if (!replayReader.open(path)) {
+        std::cerr << "Cannot open " << path << "\n";
+        return GameResult::ReturnToMenu;
+    }
+    // 只找出第一局就開始顯示，之後的棋局等換局時才往後找
+    if (!findNextReplayGame()) {
+        std::cerr << path << ": no " << Board::SIZE << "x" << Board::SIZE << " games\n";
+        replayReader.close();
+        return GameResult::ReturnToMenu;
+    }
+
+    replayAnalyzer.reset(new ReplayAnalyzer<Board::SIZE>());
+    loadReplayGame(0);
+
+    auto endPhase = [this](FrameStats::Phase phase) {
+        if (frameStats) frameStats->endPhase(phase);
+    };
+
+    while (window.isOpen() && !wantToExit && !wantToModeSelection) {
+        if (frameStats) frameStats->beginFrame();
+        handleReplayEvents(window);
+        endPhase(FrameStats::EVENTS);
+        drawReplay(window, font);
+        endPhase(FrameStats::DRAW);
+
+        if (frameStats && frameStats->overlayVisible()) drawFrameStats(window, font);
+        endPhase(FrameStats::OVERLAY);
+
+        window.display();
+        if (frameStats) frameStats->endFrame();
+    }
+
+    replayAnalyzer.reset(); // 中止背景分析
+    replayReader.close();
+    return wantToModeSelection ? GameResult::ReturnToMenu : GameResult::Exit;
+}
+
+
+// 從上次停下的位置往後找下一局 Board::SIZE 的棋局，記下它的位置；檔案走完回傳 false
+bool GameWindow::findNextReplayGame() {
+    if (replayAllFound) return false;
+    GameRecordReader::GameView view;
+    for (size_t pos = replayReader.tell(); replayReader.next(view); pos = replayReader.tell()) {
+        if (view.boardSize() == Board::SIZE) {
+            replayGames.push_back(pos);
+            return true;
+        }
+    }
+    replayAllFound = true;
+    return false;
+}
+
+
+bool GameWindow::loadReplayGame(int index) {
+    while (index >= static_cast<int>(replayGames.size()) && findNextReplayGame()) {}
+    GameRecordReader::GameView view;
+    if (index < 0 || index >= static_cast<int>(replayGames.size()) || !replayReader.viewAt(replayGames[index], view))
+        return false;
+
+    std::vector<std::pair<int, int>> moves;
+    for (int i = 0; i < view.moveCount(); ++i) moves.push_back(view.move(i));
+    if (!replay.load(moves, view.rule()))
+        std::cerr << "Game " << index + 1 << ": illegal move " << replay.length() + 1 << ", truncated\n";
+    replayGame = index;
+
+    replayTitle = view.black() + " vs " + view.white();
+    switch (view.result()) {
+        case RecordResult::BlackWin: replayTitle += ", Black wins"; break;
+        case RecordResult::WhiteWin: replayTitle += ", White wins"; break;
+        case RecordResult::Draw: replayTitle += ", draw"; break;
+        default: break;
+    }
+    seekReplay(0);
+    return true;
+}
+
+
+void GameWindow::seekReplay(int ply) {
+    replay.seek(ply);
+    board = replay.board();
+    std::tie(lastMoveRow, lastMoveCol) = replay.lastMove();
+    lastPlayerSymbol = replay.ply() > 0 ? GameReplay<Board::SIZE>::symbolAt(replay.ply() - 1) : ' ';
+    replayAnalyzer->request(replay, REPLAY_PREFETCH);
+}
+
+
+void GameWindow::handleReplayEvents(sf::RenderWindow& window) {
+    auto go = [this](int ply) {
+        ply = std::clamp(ply, 0, replay.length());
+        if (ply != replay.ply()) seekReplay(ply);
+    };
+
+    sf::Event event;
+    while (window.pollEvent(event)) {
+        if (event.type == sf::Event::Closed) {
+            wantToExit = true;
+            window.close();
+            return;
+        }
+        handleFrameStatsKey(event);
+
+        if (event.type == sf::Event::KeyPressed) {
+            switch (event.key.code) {
+                case sf::Keyboard::Left: go(replay.ply() - 1); break;
+                case sf::Keyboard::Right: go(replay.ply() + 1); break;
+                case sf::Keyboard::Home: go(0); break;
+                case sf::Keyboard::End: go(replay.length()); break;
+                case sf::Keyboard::Up: loadReplayGame(replayGame - 1); break;
+                case sf::Keyboard::Down: loadReplayGame(replayGame + 1); break;
+                case sf::Keyboard::Escape: wantToModeSelection = true; return;
+                default: break;
+            }
+        }
+
+        if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+            sf::Vector2f pos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
+            // 進度列上下各放寬幾個像素，比較好點
+            replayScrubbing = sf::FloatRect(REPLAY_BAR_X, REPLAY_BAR_Y - 6.f, REPLAY_BAR_WIDTH, REPLAY_BAR_HEIGHT + 12.f).contains(pos);
+        }
+        if (event.type == sf::Event::MouseButtonReleased) replayScrubbing = false;
+    }
+
+    if (replayScrubbing) {
+        sf::Vector2f pos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
+        go(static_cast<int>(std::lround((pos.x - REPLAY_BAR_X) / REPLAY_BAR_WIDTH * replay.length())));
+    }
+}
+
+
+void GameWindow::drawReplay(sf::RenderWindow& window, sf::Font& font) {
+    window.clear(sf::Color(255, 248, 220));
+    drawBoard(window);
+
+    // 背景評估的最佳步用熱度圖第一名的顏色標出
+    SearchResult eval;
+    const bool evaluated = replayAnalyzer->lookup(replay.key(), eval);
+    if (evaluated && eval.move.first >= 0) {
+        sf::RectangleShape best(sf::Vector2f(CELL_SIZE - 2, CELL_SIZE - 2));
+        best.setPosition(eval.move.second * CELL_SIZE + 1, eval.move.first * CELL_SIZE + 1);
+        best.setFillColor(sf::Color(255, 0, 0, 200));
+        drawItem(window, best);
+    }
+
+    // 最後一手標上紅點
+    if (lastMoveRow >= 0) {
+        sf::CircleShape mark(4);
+        mark.setPosition(lastMoveCol * CELL_SIZE + CELL_SIZE / 2 - 4, lastMoveRow * CELL_SIZE + CELL_SIZE / 2 - 4);
+        mark.setFillColor(sf::Color::Red);
+        drawItem(window, mark);
+    }
+
+    sf::Text info;
+    info.setFont(font);
+    info.setCharacterSize(16);
+    info.setFillColor(sf::Color::Black);
+    // 還沒走到檔尾時不知道總局數
+    const std::string gameCount = replayAllFound ? std::to_string(replayGames.size()) : "?";
+    info.setString("Game " + std::to_string(replayGame + 1) + "/" + gameCount + "   Ply " +
+                   std::to_string(replay.ply()) + "/" + std::to_string(replay.length()) + "   " + replayTitle);
+    info.setPosition(10, 602);
+    drawItem(window, info);
+
+    sf::RectangleShape bar(sf::Vector2f(REPLAY_BAR_WIDTH, REPLAY_BAR_HEIGHT));
+    bar.setPosition(REPLAY_BAR_X, REPLAY_BAR_Y);
+    bar.setFillColor(sf::Color(245, 222, 179));
+    bar.setOutlineThickness(1);
+    bar.setOutlineColor(sf::Color(160, 82, 45));
+    drawItem(window, bar);
+    if (replay.length() > 0) {
+        sf::RectangleShape done(sf::Vector2f(REPLAY_BAR_WIDTH * replay.ply() / replay.length(), REPLAY_BAR_HEIGHT));
+        done.setPosition(REPLAY_BAR_X, REPLAY_BAR_Y);
+        done.setFillColor(sf::Color(160, 82, 45));
+        drawItem(window, done);
+    }
+
+    // 分數換成黑棋的角度，來回瀏覽時正負號才一致
+    std::string evalText;
+    if (replay.isOver()) {
+        const char winner = replay.winner(); // 依棋譜記錄的規則判定
+        evalText = winner == 'X' ? "Black wins" : winner == 'O' ? "White wins" : "Draw";
+    } else if (evaluated) {
+        int black = replay.sideToMove() == 'X' ? eval.score : -eval.score;
+        evalText = "Black " + std::string(black >= 0 ? "+" : "") + std::to_string(black);
+        if (eval.move.first >= 0) evalText += "  best " + moveName(eval.move);
+    } else {
+        evalText = "Evaluating...";
+    }
+    sf::Text evalLabel(evalText, font, 14);
+    evalLabel.setFillColor(sf::Color::Black);
+    evalLabel.setPosition(400, 624);
+    drawItem(window, evalLabel);
+
+    sf::Text help("Left/Right: step   Home/End   Up/Down: game   drag bar: seek   Esc: menu", font, 12);
+    help.setFillColor(sf::Color(90, 90, 90));
+    help.setPosition(10, 643);
+    drawItem(window, help);
+}
+
+
+bool GameWindow::showModeSelection(sf::RenderWindow& window, sf::Font& font, bool& isPvP, bool& isReplay) {
     sf::Text title("Select Game Mode", font, 36);
     title.setFillColor(sf::Color::Black);
     title.setPosition(145, 60);
@@ -361,15 +776,15 @@ bool GameWindow::showModeSelection(sf::RenderWindow& window, sf::Font& font, boo
         float hoverAlpha = 0.0f;
     };
 
-    std::vector<Button> buttons(3);
+    std::vector<Button> buttons(4);
 
     const std::vector<std::string> labels = {
-        "Player vs Player", "Player vs Computer", "Exit Game"
+        "Player vs Player", "Player vs Computer", "Replay Games", "Exit Game"
     };
     const float startY = 180;
     const float spacing = 80;
 
-    for (int i = 0; i < 3; ++i) {
+    for (int i = 0; i < 4; ++i) {
         auto& btn = buttons[i];
 
         btn.shape.setSize(sf::Vector2f(300, 50));
@@ -397,11 +812,13 @@ bool GameWindow::showModeSelection(sf::RenderWindow& window, sf::Font& font, boo
             }
             if (event.type == sf::Event::MouseButtonPressed &&
                 event.mouseButton.button == sf::Mouse::Left) {
-                for (int i = 0; i < 3; ++i) {
+                for (int i = 0; i < 4; ++i) {
                     if (buttons[i].shape.getGlobalBounds().contains(mousePos)) {
+                        isReplay = (i == 2);
                         if (i == 0) { isPvP = true; return true; }
                         if (i == 1) { isPvP = false; return true; }
-                        if (i == 2) { window.close(); return false; }
+                        if (i == 2) return true;
+                        if (i == 3) { window.close(); return false; }
                     }
                 }
             }
@@ -0,0 +1,341 @@
+#include "LargePages.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+static LargePagePolicy currentPolicy;
+
+void setLargePagePolicy(const LargePagePolicy& policy) {
+    currentPolicy = policy;
+}
+
+const LargePagePolicy& largePagePolicy() {
+    return currentPolicy;
+}
+
+bool LargePagePolicy::parsePages(const std::string& text, Pages& out) {
+    if (text == "off") out = Pages::Normal;
+    else if (text == "thp") out = Pages::Transparent;
+    else if (text == "explicit") out = Pages::Explicit;
+    else return false;
+    return true;
+}
+
+bool LargePagePolicy::parseNuma(const std::string& text, Numa& out) {
+    if (text == "local") out = Numa::Local;
+    else if (text == "interleave") out = Numa::Interleave;
+    else if (text == "firsttouch") out = Numa::FirstTouch;
+    else return false;
+    return true;
+}
+
+// --- 系統拓樸 --- //
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus; // 行程可用的 CPU
+};
+
+struct Topology {
+    std::vector<NumaNode> nodes; // 至少一個
+    int cpuCount = 0;
+    size_t hugePageSize = 2 * 1024 * 1024;
+    size_t hugePagesReserved = 0;
+    std::string thpMode = "unavailable"; // always / madvise / never
+};
+
+#ifdef __linux__
+
+// "0-3,8-11" 形式的清單
+static std::vector<int> parseList(const std::string& text) {
+    std::vector<int> values;
+    std::istringstream in(text);
+    std::string part;
+    while (std::getline(in, part, ',')) {
+        if (part.empty() || part == "\n") continue;
+        size_t dash = part.find('-');
+        try {
+            int lo = std::stoi(part.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+            for (int v = lo; v <= hi; ++v) values.push_back(v);
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return values;
+}
+
+static std::string readFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+static Topology detectTopology() {
+    Topology t;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool haveAffinity = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    auto usable = [&](int cpu) { return !haveAffinity || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)); };
+
+    for (int id : parseList(readFirstLine("/sys/devices/system/node/online"))) {
+        NumaNode node{id, {}};
+        for (int cpu : parseList(readFirstLine("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist")))
+            if (usable(cpu)) node.cpus.push_back(cpu);
+        if (!node.cpus.empty()) t.nodes.push_back(std::move(node)); // 沒有可用 CPU 的節點不放表格
+    }
+    if (t.nodes.empty()) {
+        NumaNode all{0, {}};
+        int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < std::max(n, haveAffinity ? CPU_COUNT(&allowed) : 0); ++cpu)
+            if (usable(cpu)) all.cpus.push_back(cpu);
+        t.nodes.push_back(std::move(all));
+    }
+    for (auto& node : t.nodes) t.cpuCount += static_cast<int>(node.cpus.size());
+
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    size_t value;
+    while (meminfo >> key >> value) {
+        if (key == "Hugepagesize:") t.hugePageSize = value * 1024;
+        else if (key == "HugePages_Total:") t.hugePagesReserved = value;
+        meminfo.ignore(256, '\n');
+    }
+
+    // "always [madvise] never"：方括號內是目前的模式
+    std::string thp = readFirstLine("/sys/kernel/mm/transparent_hugepage/enabled");
+    size_t open = thp.find('['), close = thp.find(']');
+    if (open != std::string::npos && close > open) t.thpMode = thp.substr(open + 1, close - open - 1);
+    return t;
+}
+
+#else
+
+static Topology detectTopology() {
+    Topology t;
+    NumaNode all{0, {}};
+    int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int cpu = 0; cpu < n; ++cpu) all.cpus.push_back(cpu);
+    t.nodes.push_back(std::move(all));
+    t.cpuCount = n;
+    return t;
+}
+
+#endif
+
+static const Topology& topology() {
+    static const Topology t = detectTopology();
+    return t;
+}
+
+int numaNodeCount() {
+    return static_cast<int>(topology().nodes.size());
+}
+
+std::string memoryTopologySummary() {
+    const Topology& t = topology();
+    std::ostringstream out;
+    out << t.nodes.size() << " NUMA node" << (t.nodes.size() > 1 ? "s" : "") << ", " << t.cpuCount << " CPUs, THP "
+        << t.thpMode << ", " << t.hugePageSize / 1024 << " kB huge pages (" << t.hugePagesReserved << " reserved)";
+    return out.str();
+}
+
+// --- 執行緒綁定 --- //
+
+static int cpuForSlot(int slot) {
+    const auto& nodes = topology().nodes;
+    const auto& cpus = nodes[slot % nodes.size()].cpus;
+    return cpus[(slot / nodes.size()) % cpus.size()];
+}
+
+#if defined(__linux__)
+
+static bool pinToCpus(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+#elif defined(_WIN32)
+
+static bool pinToCpus(const std::vector<int>& cpus) {
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus)
+        if (cpu < 64) mask |= DWORD_PTR(1) << cpu; // 只處理第一個處理器群組
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+#else
+
+static bool pinToCpus(const std::vector<int>&) {
+    return false;
+}
+
+#endif
+
+bool pinCurrentThread(int slot) {
+    if (slot < 0) return false;
+    return pinToCpus({cpuForSlot(slot)});
+}
+
+// --- 配置 --- //
+
+LargeBuffer::~LargeBuffer() {
+    release();
+}
+
+std::string LargeBuffer::describe() const {
+    static const char* PAGES[] = {"normal", "thp", "explicit"};
+    static const char* NUMA[] = {"local", "interleave", "firsttouch"};
+    return std::string(PAGES[static_cast<int>(usedPages)]) + "/" + NUMA[static_cast<int>(usedNuma)];
+}
+
+#ifdef _WIN32
+
+bool LargeBuffer::allocate(size_t bytes) {
+    release();
+    const LargePagePolicy& policy = largePagePolicy();
+    size_t large = GetLargePageMinimum();
+
+    // 大頁需要「鎖定記憶體分頁」權限，沒有時 VirtualAlloc 會失敗，改用一般頁面
+    if (policy.pages == LargePagePolicy::Pages::Explicit && large > 0 && bytes >= large) {
+        size_t rounded = (bytes + large - 1) / large * large;
+        mapping = VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (mapping) {
+            mappingLength = rounded;
+            usedPages = LargePagePolicy::Pages::Explicit;
+        }
+    }
+    if (!mapping) {
+        mapping = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!mapping) return false;
+        mappingLength = bytes;
+        usedPages = LargePagePolicy::Pages::Normal;
+    }
+    usedNuma = LargePagePolicy::Numa::Local;
+    base = mapping;
+    length = bytes;
+    return true;
+}
+
+void LargeBuffer::release() {
+    if (mapping) VirtualFree(mapping, 0, MEM_RELEASE);
+    mapping = base = nullptr;
+    mappingLength = length = 0;
+}
+
+#else
+
+#ifdef __linux__
+// 不依賴 libnuma：直接呼叫 mbind(2)
+static const int MPOL_INTERLEAVE_MODE = 3;
+
+static bool interleave(void* addr, size_t len, const std::vector<NumaNode>& nodes) {
+    int maxId = 0;
+    for (auto& node : nodes) maxId = std::max(maxId, node.id);
+    const int BITS = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(maxId / BITS + 1, 0);
+    for (auto& node : nodes) mask[node.id / BITS] |= 1UL << (node.id % BITS);
+    // maxnode 比遮罩的位元數多 1（核心會先減 1）
+    return syscall(SYS_mbind, addr, len, MPOL_INTERLEAVE_MODE, mask.data(), mask.size() * BITS + 1, 0) == 0;
+}
+
+// 每個節點一條綁在該節點上的執行緒，各自寫入一段，頁面就配置在寫入者的節點上
+static void firstTouch(unsigned char* addr, size_t len, size_t page, const std::vector<NumaNode>& nodes) {
+    size_t pages = (len + page - 1) / page;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        size_t begin = std::min(len, pages * i / nodes.size() * page);
+        size_t end = std::min(len, pages * (i + 1) / nodes.size() * page);
+        threads.emplace_back([=, &nodes]() {
+            pinToCpus(nodes[i].cpus);
+            std::memset(addr + begin, 0, end - begin);
+        });
+    }
+    for (auto& t : threads) t.join();
+}
+#endif
+
+bool LargeBuffer::allocate(size_t bytes) {
+    release();
+    if (bytes == 0) return false;
+    const LargePagePolicy& policy = largePagePolicy();
+    const Topology& topo = topology();
+    const size_t huge = topo.hugePageSize;
+    const bool bigEnough = bytes >= huge;
+    usedPages = LargePagePolicy::Pages::Normal;
+
+#ifdef MAP_HUGETLB
+    // 預留的大頁：數量不足時 mmap 直接失敗，接著退回透明大頁
+    if (policy.pages == LargePagePolicy::Pages::Explicit && bigEnough) {
+        size_t rounded = (bytes + huge - 1) / huge * huge;
+        void* p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            mapping = base = p;
+            mappingLength = rounded;
+            usedPages = LargePagePolicy::Pages::Explicit;
+        }
+    }
+#endif
+
+    if (!mapping) {
+        // 多映射一個大頁的長度再對齊起點，透明大頁才能從第一頁開始生效
+        bool wantThp = policy.pages != LargePagePolicy::Pages::Normal && bigEnough;
+        size_t extra = wantThp ? huge : 0;
+        void* p = mmap(nullptr, bytes + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return false;
+        mapping = p;
+        mappingLength = bytes + extra;
+        uintptr_t aligned = extra ? (reinterpret_cast<uintptr_t>(p) + huge - 1) / huge * huge : reinterpret_cast<uintptr_t>(p);
+        base = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        if (wantThp && topo.thpMode != "never" && madvise(base, bytes, MADV_HUGEPAGE) == 0)
+            usedPages = LargePagePolicy::Pages::Transparent;
+#endif
+    }
+    length = bytes;
+
+    // NUMA：只有一個節點時什麼都不用做
+    usedNuma = LargePagePolicy::Numa::Local;
+#ifdef __linux__
+    if (topo.nodes.size() > 1) {
+        if (policy.numa == LargePagePolicy::Numa::Interleave && interleave(base, length, topo.nodes)) {
+            usedNuma = LargePagePolicy::Numa::Interleave;
+        } else if (policy.numa == LargePagePolicy::Numa::FirstTouch) {
+            firstTouch(static_cast<unsigned char*>(base), length,
+                       usedPages == LargePagePolicy::Pages::Normal ? static_cast<size_t>(sysconf(_SC_PAGESIZE)) : huge,
+                       topo.nodes);
+            usedNuma = LargePagePolicy::Numa::FirstTouch;
+        }
+    }
+#endif
+    return true;
+}
+
+void LargeBuffer::release() {
+    if (mapping) munmap(mapping, mappingLength);
+    mapping = base = nullptr;
+    mappingLength = length = 0;
+}
+
+#endif
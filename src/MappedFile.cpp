@@ -0,0 +1,150 @@
+#include "MappedFile.hpp"
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(base, other.base);
+        std::swap(length, other.length);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#else
+        std::swap(fd, other.fd);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::openRead(const std::string& path) {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    length = static_cast<size_t>(size.QuadPart);
+    return map(false);
+}
+
+bool MappedFile::openReadWrite(const std::string& path, size_t size) {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER newSize;
+    newSize.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(file, newSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    length = size;
+    return map(true);
+}
+
+bool MappedFile::map(bool writable) {
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle) base = MapViewOfFile(mappingHandle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length);
+    if (!base) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::flush() {
+    if (base) FlushViewOfFile(base, length);
+}
+
+void MappedFile::adviseHugePages() {}
+
+void MappedFile::close() {
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    base = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    length = 0;
+}
+
+#else
+
+bool MappedFile::openRead(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(st.st_size);
+    return map(false);
+}
+
+bool MappedFile::openReadWrite(const std::string& path, size_t size) {
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close();
+        return false;
+    }
+    length = size;
+    return map(true);
+}
+
+bool MappedFile::map(bool writable) {
+    void* p = mmap(nullptr, length, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        close();
+        return false;
+    }
+    base = p;
+    return true;
+}
+
+void MappedFile::flush() {
+    if (base) msync(base, length, MS_SYNC);
+}
+
+void MappedFile::adviseHugePages() {
+#ifdef MADV_HUGEPAGE
+    if (base) madvise(base, length, MADV_HUGEPAGE);
+#endif
+}
+
+void MappedFile::close() {
+    if (base) munmap(base, length);
+    if (fd >= 0) ::close(fd);
+    base = nullptr;
+    fd = -1;
+    length = 0;
+}
+
+#endif
@@ -0,0 +1,240 @@
+#include "Nnue.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// AVX2 路徑：GCC / Clang 以 target 屬性單獨編譯這幾個函式，執行時再確認 CPU 支援；
+// MSVC 需以 /arch:AVX2 建置才會啟用
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define NNUE_AVX2 1
+#define NNUE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#define NNUE_AVX2 1
+#define NNUE_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+static const char NNUE_MAGIC[8] = {'G', 'M', 'K', 'N', 'N', 'U', 'E', '\0'};
+
+struct NnueFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t boardSize;
+    uint32_t hidden;
+    uint32_t hidden2;
+    int32_t outputScale;
+    uint32_t reserved;
+};
+
+bool NnueNetwork::simdSupported() {
+#if defined(NNUE_AVX2) && defined(_MSC_VER)
+    return true;
+#elif defined(NNUE_AVX2)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool NnueNetwork::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    NnueFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, NNUE_MAGIC, sizeof(NNUE_MAGIC)) != 0 || header.version != FILE_VERSION ||
+        header.hidden != HIDDEN || header.hidden2 != HIDDEN2 || header.boardSize < 5 || header.boardSize > 32) {
+        std::cerr << path << ": not a compatible network file\n";
+        return false;
+    }
+
+    std::vector<int16_t> rows(static_cast<size_t>(header.boardSize) * header.boardSize * 2 * HIDDEN);
+    in.read(reinterpret_cast<char*>(rows.data()), rows.size() * sizeof(int16_t));
+    in.read(reinterpret_cast<char*>(b1), sizeof(b1));
+    in.read(reinterpret_cast<char*>(w2), sizeof(w2));
+    in.read(reinterpret_cast<char*>(b2), sizeof(b2));
+    in.read(reinterpret_cast<char*>(w3), sizeof(w3));
+    in.read(reinterpret_cast<char*>(&b3), sizeof(b3));
+    if (!in) {
+        std::cerr << path << ": truncated network file\n";
+        size = 0;
+        return false;
+    }
+
+    w1 = std::move(rows);
+    size = static_cast<int>(header.boardSize);
+    outputScale = header.outputScale;
+    simd = simdSupported();
+    updateChecksum();
+    return true;
+}
+
+bool NnueNetwork::save(const std::string& path) const {
+    if (!isLoaded()) return false;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    NnueFileHeader header{};
+    std::memcpy(header.magic, NNUE_MAGIC, sizeof(NNUE_MAGIC));
+    header.version = FILE_VERSION;
+    header.boardSize = static_cast<uint32_t>(size);
+    header.hidden = HIDDEN;
+    header.hidden2 = HIDDEN2;
+    header.outputScale = outputScale;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(w1.data()), w1.size() * sizeof(int16_t));
+    out.write(reinterpret_cast<const char*>(b1), sizeof(b1));
+    out.write(reinterpret_cast<const char*>(w2), sizeof(w2));
+    out.write(reinterpret_cast<const char*>(b2), sizeof(b2));
+    out.write(reinterpret_cast<const char*>(w3), sizeof(w3));
+    out.write(reinterpret_cast<const char*>(&b3), sizeof(b3));
+    return static_cast<bool>(out);
+}
+
+void NnueNetwork::randomize(int boardSize, uint64_t seed) {
+    uint64_t state = seed;
+    auto next = [&](int range) { // splitmix64，回傳 [-range, range]
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return static_cast<int>(z % (2 * range + 1)) - range;
+    };
+
+    size = boardSize;
+    w1.resize(static_cast<size_t>(boardSize) * boardSize * 2 * HIDDEN);
+    for (auto& w : w1) w = static_cast<int16_t>(next(24));
+    for (auto& b : b1) b = static_cast<int16_t>(next(16) + 32);
+    for (auto& row : w2)
+        for (auto& w : row) w = static_cast<int8_t>(next(32));
+    for (auto& b : b2) b = next(256);
+    for (auto& w : w3) w = static_cast<int8_t>(next(64));
+    b3 = 0;
+    outputScale = 16;
+    simd = simdSupported();
+    updateChecksum();
+}
+
+void NnueNetwork::updateChecksum() {
+    checksum = 1469598103934665603ULL; // FNV-1a
+    auto mix = [&](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            checksum ^= p[i];
+            checksum *= 1099511628211ULL;
+        }
+    };
+    mix(&size, sizeof(size));
+    mix(&outputScale, sizeof(outputScale));
+    mix(w1.data(), w1.size() * sizeof(int16_t));
+    mix(b1, sizeof(b1));
+    mix(w2, sizeof(w2));
+    mix(b2, sizeof(b2));
+    mix(w3, sizeof(w3));
+    mix(&b3, sizeof(b3));
+}
+
+// --- 累加器 --- //
+
+void NnueNetwork::reset(Accumulator& acc) const {
+    std::memcpy(acc.v, b1, sizeof(acc.v));
+}
+
+void NnueNetwork::add(Accumulator& acc, int cell, int color) const {
+    const int16_t* row = &w1[(static_cast<size_t>(cell) * 2 + color) * HIDDEN];
+#ifdef NNUE_AVX2
+    if (simd) return addAvx2(acc, row, false);
+#endif
+    for (int i = 0; i < HIDDEN; ++i) acc.v[i] = static_cast<int16_t>(acc.v[i] + row[i]);
+}
+
+void NnueNetwork::sub(Accumulator& acc, int cell, int color) const {
+    const int16_t* row = &w1[(static_cast<size_t>(cell) * 2 + color) * HIDDEN];
+#ifdef NNUE_AVX2
+    if (simd) return addAvx2(acc, row, true);
+#endif
+    for (int i = 0; i < HIDDEN; ++i) acc.v[i] = static_cast<int16_t>(acc.v[i] - row[i]);
+}
+
+// --- 推論 --- //
+
+int NnueNetwork::evaluate(const Accumulator& acc) const {
+#ifdef NNUE_AVX2
+    if (simd) return evaluateAvx2(acc);
+#endif
+    return evaluateScalar(acc);
+}
+
+int NnueNetwork::evaluateScalar(const Accumulator& acc) const {
+    uint8_t in[HIDDEN];
+    for (int i = 0; i < HIDDEN; ++i) in[i] = static_cast<uint8_t>(std::min<int>(127, std::max<int>(0, acc.v[i])));
+
+    uint8_t hidden[HIDDEN2];
+    for (int j = 0; j < HIDDEN2; ++j) {
+        int32_t sum = b2[j];
+        for (int i = 0; i < HIDDEN; ++i) sum += in[i] * w2[j][i];
+        hidden[j] = static_cast<uint8_t>(std::min(127, std::max(0, sum >> 6)));
+    }
+
+    int32_t out = b3;
+    for (int j = 0; j < HIDDEN2; ++j) out += hidden[j] * w3[j];
+    return out * outputScale / 64;
+}
+
+#ifdef NNUE_AVX2
+
+NNUE_TARGET_AVX2 static inline int32_t horizontalSum(__m256i v) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+// 32 個 uint8 × int8 的內積：maddubs 先兩兩相加成 int16（127*128*2 不會溢位），再 madd 成 int32
+NNUE_TARGET_AVX2 static inline __m256i dot32(__m256i in, const int8_t* weights) {
+    __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights));
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), _mm256_set1_epi16(1));
+}
+
+NNUE_TARGET_AVX2 void NnueNetwork::addAvx2(Accumulator& acc, const int16_t* row, bool subtract) const {
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc.v + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        a = subtract ? _mm256_sub_epi16(a, w) : _mm256_add_epi16(a, w);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc.v + i), a);
+    }
+}
+
+NNUE_TARGET_AVX2 int NnueNetwork::evaluateAvx2(const Accumulator& acc) const {
+    static_assert(HIDDEN == 64 && HIDDEN2 == 32, "AVX2 路徑假設 64 / 32 個神經元");
+
+    // clamp(0,127) 後壓成 uint8；packus 會交錯兩個 128-bit 半邊，permute 排回原順序
+    const __m256i zero = _mm256_setzero_si256(), max = _mm256_set1_epi16(127);
+    __m256i a[4];
+    for (int k = 0; k < 4; ++k) {
+        a[k] = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc.v + 16 * k));
+        a[k] = _mm256_max_epi16(_mm256_min_epi16(a[k], max), zero);
+    }
+    __m256i in0 = _mm256_permute4x64_epi64(_mm256_packus_epi16(a[0], a[1]), 0xD8);
+    __m256i in1 = _mm256_permute4x64_epi64(_mm256_packus_epi16(a[2], a[3]), 0xD8);
+
+    alignas(32) uint8_t hidden[HIDDEN2];
+    for (int j = 0; j < HIDDEN2; ++j) {
+        __m256i sum = _mm256_add_epi32(dot32(in0, w2[j]), dot32(in1, w2[j] + 32));
+        int32_t s = horizontalSum(sum) + b2[j];
+        hidden[j] = static_cast<uint8_t>(std::min(127, std::max(0, s >> 6)));
+    }
+
+    __m256i h = _mm256_load_si256(reinterpret_cast<const __m256i*>(hidden));
+    int32_t out = horizontalSum(dot32(h, w3)) + b3;
+    return out * outputScale / 64;
+}
+
+#else
+
+void NnueNetwork::addAvx2(Accumulator&, const int16_t*, bool) const {}
+int NnueNetwork::evaluateAvx2(const Accumulator& acc) const { return evaluateScalar(acc); }
+
+#endif
@@ -0,0 +1,98 @@
+#include "OpeningBook.hpp"
+#include "LargePages.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+static const char BOOK_MAGIC[8] = {'G', 'M', 'K', 'B', 'O', 'O', 'K', '\0'};
+
+static bool recordLess(const OpeningBook::Record& a, const OpeningBook::Record& b) {
+    if (a.hash != b.hash) return a.hash < b.hash;
+    if (a.row != b.row) return a.row < b.row;
+    return a.col < b.col;
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+    if (!file.openRead(path) || file.size() < sizeof(Header)) {
+        file.close();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 || header.version != VERSION ||
+        file.size() != sizeof(Header) + header.count * sizeof(Record)) {
+        file.close();
+        return false;
+    }
+
+    if (largePagePolicy().pages != LargePagePolicy::Pages::Normal) file.adviseHugePages(); // 二分搜尋跳躍存取，TLB 友善
+    records = reinterpret_cast<const Record*>(file.data() + sizeof(Header));
+    count = header.count;
+    size = static_cast<int>(header.boardSize);
+    return true;
+}
+
+void OpeningBook::close() {
+    file.close();
+    records = nullptr;
+    count = 0;
+    size = 0;
+}
+
+std::pair<const OpeningBook::Record*, const OpeningBook::Record*> OpeningBook::find(uint64_t hash) const {
+    if (!isOpen()) return {nullptr, nullptr};
+    auto first = std::lower_bound(records, records + count, hash,
+                                  [](const Record& r, uint64_t h) { return r.hash < h; });
+    auto last = first;
+    while (last != records + count && last->hash == hash) ++last;
+    return {first, last};
+}
+
+// 權重 = 得分率（勝 1、和 0.5）* 場數的平方根，兼顧勝率與樣本數
+uint16_t OpeningBook::computeWeight(const Record& r) {
+    if (r.games == 0) return 0;
+    double points = r.wins + 0.5 * r.draws;
+    double w = points / r.games * 1000.0 * std::min(8.0, std::sqrt(static_cast<double>(r.games)));
+    return static_cast<uint16_t>(std::min(65535.0, w));
+}
+
+bool OpeningBook::write(const std::string& path, int boardSize, std::vector<Record> input) {
+    std::sort(input.begin(), input.end(), recordLess);
+
+    std::vector<Record> merged;
+    merged.reserve(input.size());
+    for (const Record& r : input) {
+        if (!merged.empty() && !recordLess(merged.back(), r)) {
+            merged.back().games += r.games;
+            merged.back().wins += r.wins;
+            merged.back().draws += r.draws;
+        } else {
+            merged.push_back(r);
+        }
+    }
+    for (Record& r : merged) r.weight = computeWeight(r);
+
+    // 先寫到暫存檔再改名，正在使用舊檔的行程不受影響
+    std::string tmp = path + ".tmp";
+    FILE* out = std::fopen(tmp.c_str(), "wb");
+    if (!out) return false;
+
+    Header header;
+    std::memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.version = VERSION;
+    header.boardSize = static_cast<uint32_t>(boardSize);
+    header.count = merged.size();
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              (merged.empty() || std::fwrite(merged.data(), sizeof(Record), merged.size(), out) == merged.size());
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
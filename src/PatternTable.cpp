@@ -0,0 +1,75 @@
+#include "PatternTable.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+EvalWeights::EvalWeights() {
+    // 原本的手調分數：先依子數與是否被擋給基本分，一端被擋再 /2、兩端被擋 /4
+    static const int base[5][2] = {{50, 50}, {200, 200}, {5000, 1000}, {50000, 10000}, {100000, 100000}};
+    for (int stones = 1; stones <= 5; ++stones) {
+        at(stones, OPEN) = base[stones - 1][0];
+        at(stones, HALF) = base[stones - 1][1] / 2;
+        at(stones, CLOSED) = base[stones - 1][1] / 4;
+    }
+}
+
+std::string EvalWeights::name(int slot) {
+    static const char* stones[5] = {"one", "two", "three", "four", "five"};
+    static const char* ends[3] = {"open", "half", "closed"};
+    return std::string(stones[slot / 3]) + "." + ends[slot % 3];
+}
+
+bool EvalWeights::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        std::istringstream fields(line);
+        std::string key;
+        long long v;
+        if (!(fields >> key) || key[0] == '#') continue;
+        if (!(fields >> v)) {
+            std::cerr << path << ":" << lineNo << ": missing value for " << key << "\n";
+            return false;
+        }
+        int slot = 0;
+        while (slot < COUNT && name(slot) != key) ++slot;
+        if (slot == COUNT) {
+            std::cerr << path << ":" << lineNo << ": unknown key " << key << "\n";
+            return false;
+        }
+        value[slot] = static_cast<int>(v);
+    }
+    return true;
+}
+
+bool EvalWeights::save(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "# 評估權重：子數.兩端狀態 (open / half / closed)\n";
+    for (int slot = 0; slot < COUNT; ++slot) out << name(slot) << " " << value[slot] << "\n";
+    return static_cast<bool>(out);
+}
+
+int PatternTable::weightSlot(int idx, int& side) {
+    int w = idx / 4;
+    bool leftOpen = idx & 1, rightOpen = idx & 2;
+    int xs = 0, os = 0;
+    for (int j = 0; j < 5; ++j, w /= 3) {
+        if (w % 3 == 1) xs++;
+        else if (w % 3 == 2) os++;
+    }
+    if ((xs > 0) == (os > 0)) return -1; // 混色或全空
+    side = xs > 0 ? 1 : -1;
+    int ends = (leftOpen && rightOpen) ? EvalWeights::OPEN : ((leftOpen || rightOpen) ? EvalWeights::HALF : EvalWeights::CLOSED);
+    return EvalWeights::slot(xs + os, ends);
+}
+
+PatternTable::PatternTable(const EvalWeights& weights) {
+    for (int idx = 0; idx < COUNT; ++idx) {
+        int side;
+        int slot = weightSlot(idx, side);
+        score[idx] = slot < 0 ? 0 : side * weights.value[slot];
+    }
+}
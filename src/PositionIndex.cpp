@@ -0,0 +1,279 @@
+#include "PositionIndex.hpp"
+#include "Rules.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+
+static const char INDEX_MAGIC[8] = {'G', 'M', 'K', 'I', 'D', 'X', '\0', '\0'};
+
+static bool entryLess(const PositionIndex::Entry& a, const PositionIndex::Entry& b) {
+    if (a.hash != b.hash) return a.hash < b.hash;
+    if (a.game != b.game) return a.game < b.game;
+    return a.ply < b.ply;
+}
+
+// 重播 [first, last) 之間的棋局，每一步之前的局面各產生一筆索引；
+// out 滿 runEntries 筆就交給 spill（排序後寫成一段暫存檔）再清空
+template <int N, class Spill>
+static bool indexGames(const GameRecordReader& reader, const std::vector<uint64_t>& offsets, size_t first,
+                       size_t last, size_t runEntries, std::vector<PositionIndex::Entry>& out, Spill spill) {
+    for (size_t g = first; g < last; ++g) {
+        GameRecordReader::GameView game;
+        if (!reader.viewAt(offsets[g], game) || game.boardSize() != N) continue;
+
+        BasicBoard<N> board;
+        SymmetricHash<N> hash;
+        char turn = 'X';
+        const int moves = game.moveCount();
+        for (int ply = 0; ply <= moves; ++ply) {
+            int sym;
+            uint64_t key = hash.canonical(sym);
+            PositionIndex::Entry e;
+            e.hash = key;
+            e.game = static_cast<uint32_t>(g);
+            e.ply = static_cast<uint16_t>(ply);
+            e.next = PositionIndex::NO_MOVE;
+            if (ply == moves) {
+                out.push_back(e);
+                break;
+            }
+
+            auto [r, c] = game.move(ply);
+            auto canon = applySymmetry<N>(sym, r, c);
+            e.next = static_cast<uint16_t>(canon.first * N + canon.second);
+            out.push_back(e);
+
+            if (!board.placePiece(r, c, turn)) break; // 不合法的棋譜就停在這裡
+            hash.toggle(r, c, turn);
+            if (ActiveRule::isWin(board, r, c, turn)) {
+                e.hash = hash.canonical();
+                e.ply = static_cast<uint16_t>(ply + 1);
+                e.next = PositionIndex::NO_MOVE;
+                out.push_back(e);
+                break;
+            }
+            turn = (turn == 'X') ? 'O' : 'X';
+        }
+        if (out.size() >= runEntries && !spill(out)) return false;
+    }
+    return out.empty() || spill(out);
+}
+
+// 合併階段讀取一段已排序暫存檔的緩衝
+struct RunReader {
+    static const size_t BUFFER = 1 << 14;
+
+    FILE* in = nullptr;
+    std::vector<PositionIndex::Entry> buf;
+    size_t pos = 0;
+
+    bool refill() {
+        buf.resize(BUFFER);
+        buf.resize(std::fread(buf.data(), sizeof(PositionIndex::Entry), BUFFER, in));
+        pos = 0;
+        return !buf.empty();
+    }
+};
+
+bool PositionIndex::build(const std::string& recordsPath, const std::string& indexPath, int boardSize,
+                          int threads, size_t memoryMB, uint64_t* entriesOut) {
+    if (boardSize != 15 && boardSize != 19) return false;
+    GameRecordReader reader;
+    if (!reader.open(recordsPath)) return false;
+
+    // 先掃一次只取每盤的位移與結果（不解碼走法）
+    std::vector<uint64_t> offsets;
+    std::vector<uint8_t> gameResults;
+    GameRecordReader::GameView view;
+    for (size_t pos = reader.tell(); reader.next(view); pos = reader.tell()) {
+        offsets.push_back(pos);
+        gameResults.push_back(static_cast<uint8_t>(view.result()));
+    }
+
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, offsets.size())));
+    // 每個執行緒的緩衝上限；一盤棋最多多出幾百筆，不影響估算
+    const size_t runEntries = std::max<size_t>(1 << 12, (memoryMB << 20) / sizeof(Entry) / threads);
+
+    // 第一階段：每個執行緒負責一段連續的棋局，緩衝滿了就排序寫成一段暫存檔
+    std::mutex runMutex;
+    std::vector<std::string> runs;
+    uint64_t total = 0;
+    bool ok = true;
+    auto spill = [&](std::vector<Entry>& part) {
+        std::sort(part.begin(), part.end(), entryLess);
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(runMutex);
+            path = indexPath + ".run" + std::to_string(runs.size());
+            runs.push_back(path);
+            total += part.size();
+        }
+        FILE* run = std::fopen(path.c_str(), "wb");
+        bool written = run && std::fwrite(part.data(), sizeof(Entry), part.size(), run) == part.size();
+        written = (run && std::fclose(run) == 0) && written;
+        part.clear();
+        return written;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<char> workerOk(threads, 1);
+    for (int t = 0; t < threads; ++t) {
+        size_t first = offsets.size() * t / threads;
+        size_t last = offsets.size() * (t + 1) / threads;
+        workers.emplace_back([&, t, first, last]() {
+            std::vector<Entry> part;
+            part.reserve(std::min<size_t>(runEntries, 1 << 20));
+            workerOk[t] = dispatchBoardSize(boardSize, [&](auto n) {
+                return indexGames<decltype(n)::value>(reader, offsets, first, last, runEntries, part, spill);
+            });
+        });
+    }
+    for (auto& w : workers) w.join();
+    for (char w : workerOk) ok = ok && w;
+
+    // 第二階段：所有暫存檔一次 k 路合併，直接寫進索引檔
+    std::string tmp = indexPath + ".tmp";
+    FILE* out = ok ? std::fopen(tmp.c_str(), "wb") : nullptr;
+    ok = ok && out;
+
+    std::vector<RunReader> readers(runs.size());
+    using Head = std::pair<Entry, size_t>; // (目前最小的一筆, 第幾段)
+    auto greater = [](const Head& a, const Head& b) { return entryLess(b.first, a.first); };
+    std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+    for (size_t i = 0; ok && i < runs.size(); ++i) {
+        readers[i].in = std::fopen(runs[i].c_str(), "rb");
+        ok = readers[i].in != nullptr;
+        if (ok && readers[i].refill()) heads.emplace(readers[i].buf[0], i);
+    }
+
+    if (ok) {
+        Header header;
+        std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        header.version = VERSION;
+        header.boardSize = static_cast<uint32_t>(boardSize);
+        header.entryCount = total;
+        header.gameCount = offsets.size();
+        ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+
+        std::vector<Entry> pending;
+        pending.reserve(RunReader::BUFFER);
+        uint64_t merged = 0;
+        while (ok && !heads.empty()) {
+            auto [e, i] = heads.top();
+            heads.pop();
+            pending.push_back(e);
+            RunReader& r = readers[i];
+            if (++r.pos < r.buf.size() || r.refill()) heads.emplace(r.buf[r.pos], i);
+            if (pending.size() == RunReader::BUFFER || heads.empty()) {
+                ok = std::fwrite(pending.data(), sizeof(Entry), pending.size(), out) == pending.size();
+                merged += pending.size();
+                pending.clear();
+            }
+        }
+        ok = ok && merged == total;
+        if (!offsets.empty()) {
+            ok = ok && std::fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), out) == offsets.size();
+            ok = ok && std::fwrite(gameResults.data(), 1, gameResults.size(), out) == gameResults.size();
+        }
+    }
+
+    for (RunReader& r : readers)
+        if (r.in) std::fclose(r.in);
+    for (const std::string& run : runs) std::remove(run.c_str());
+    if (out) ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    std::remove(indexPath.c_str());
+    if (std::rename(tmp.c_str(), indexPath.c_str()) != 0) return false;
+    if (entriesOut) *entriesOut = total;
+    return true;
+}
+
+bool PositionIndex::open(const std::string& path) {
+    close();
+    if (!file.openRead(path) || file.size() < sizeof(Header)) {
+        file.close();
+        return false;
+    }
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    uint64_t expected = sizeof(Header) + header.entryCount * sizeof(Entry) + header.gameCount * (sizeof(uint64_t) + 1);
+    if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.version != VERSION ||
+        file.size() != expected) {
+        file.close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const Entry*>(file.data() + sizeof(Header));
+    offsets = reinterpret_cast<const uint64_t*>(entries + header.entryCount);
+    results = reinterpret_cast<const uint8_t*>(offsets + header.gameCount);
+    count = header.entryCount;
+    games = header.gameCount;
+    size = static_cast<int>(header.boardSize);
+    return true;
+}
+
+void PositionIndex::close() {
+    file.close();
+    entries = nullptr;
+    offsets = nullptr;
+    results = nullptr;
+    count = games = 0;
+    size = 0;
+}
+
+std::pair<const PositionIndex::Entry*, const PositionIndex::Entry*> PositionIndex::find(uint64_t hash) const {
+    if (!isOpen()) return {nullptr, nullptr};
+    auto first = std::lower_bound(entries, entries + count, hash,
+                                  [](const Entry& e, uint64_t h) { return e.hash < h; });
+    auto last = std::upper_bound(first, entries + count, hash,
+                                 [](uint64_t h, const Entry& e) { return h < e.hash; });
+    return {first, last};
+}
+
+PositionIndex::Summary PositionIndex::summarize(std::pair<const Entry*, const Entry*> range, int toQuery,
+                                                size_t maxHits) const {
+    Summary summary;
+    std::map<uint16_t, MoveStat> next;
+    uint32_t lastGame = UINT32_MAX;
+
+    for (const Entry* e = range.first; e != range.second; ++e) {
+        if (summary.hits.size() < maxHits) summary.hits.emplace_back(e->game, e->ply);
+
+        // 同一盤棋可能因為對稱而多次走到同一局面，只算一次
+        uint8_t result = results[e->game];
+        if (e->game != lastGame) {
+            summary.games++;
+            if (result == static_cast<uint8_t>(RecordResult::BlackWin)) summary.blackWins++;
+            else if (result == static_cast<uint8_t>(RecordResult::WhiteWin)) summary.whiteWins++;
+            else if (result == static_cast<uint8_t>(RecordResult::Draw)) summary.draws++;
+            lastGame = e->game;
+        }
+
+        if (e->next == NO_MOVE) continue;
+        MoveStat& stat = next[e->next];
+        stat.games++;
+        if (result == static_cast<uint8_t>(RecordResult::BlackWin)) stat.blackWins++;
+        else if (result == static_cast<uint8_t>(RecordResult::WhiteWin)) stat.whiteWins++;
+        else if (result == static_cast<uint8_t>(RecordResult::Draw)) stat.draws++;
+    }
+
+    for (auto& [cell, stat] : next) {
+        int r = cell / size, c = cell % size;
+        auto move = applySymmetry(size, toQuery, r, c);
+        stat.row = move.first;
+        stat.col = move.second;
+        summary.nextMoves.push_back(stat);
+    }
+    std::sort(summary.nextMoves.begin(), summary.nextMoves.end(),
+              [](const MoveStat& a, const MoveStat& b) { return a.games > b.games; });
+    return summary;
+}
@@ -0,0 +1,103 @@
+#include "PotentialMap.hpp"
+#include <algorithm>
+
+static const int DIRS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+static const int REACH = 4;    // 經過落子點的五格窗口最遠延伸到前後 4 格
+static const int CODES = 6561; // 3^8
+
+// 窗口內已有 k 顆己方子（不含落子點）時的分數：k = 4 即成五，3 成四，2 成三
+static const int32_t WINDOW_SCORE[5] = {1, 6, 40, 400, 20000};
+
+// 前後各 4 格（0 空、1 己方、2 擋住：對方或邊界）的三進位編碼 → 該方向的潛力
+static const int32_t* potentialTable() {
+    static const struct Table {
+        int32_t score[CODES];
+        Table() {
+            for (int code = 0; code < CODES; ++code) {
+                int cells[2 * REACH + 1];
+                int rest = code;
+                for (int i = 0; i < 2 * REACH + 1; ++i) {
+                    if (i == REACH) {
+                        cells[i] = 0;
+                        continue;
+                    }
+                    cells[i] = rest % 3;
+                    rest /= 3;
+                }
+                int32_t total = 0;
+                for (int start = 0; start <= REACH; ++start) {
+                    int own = 0;
+                    bool blocked = false;
+                    for (int i = start; i < start + 5; ++i) {
+                        blocked |= cells[i] == 2;
+                        own += cells[i] == 1;
+                    }
+                    if (!blocked) total += WINDOW_SCORE[own];
+                }
+                score[code] = total;
+            }
+        }
+    } instance;
+    return instance.score;
+}
+
+template <int N>
+void PotentialMap<N>::updateCell(const BasicBoard<N>& board, int row, int col, int d) {
+    const int cell = row * N + col;
+    if (board.cellCode(row, col) != 0) {
+        dir[0][d][cell] = dir[1][d][cell] = 0;
+        return;
+    }
+
+    // cellCode 加上 3 = 邊界，分別換成 X、O 角度的編碼
+    static const int asX[4] = {0, 1, 2, 2}, asO[4] = {0, 2, 1, 2};
+    int codeX = 0, codeO = 0, mul = 1;
+    for (int i = -REACH; i <= REACH; ++i) {
+        if (i == 0) continue;
+        int r = row + DIRS[d][0] * i, c = col + DIRS[d][1] * i;
+        int v = (r < 0 || r >= N || c < 0 || c >= N) ? 3 : board.cellCode(r, c);
+        codeX += asX[v] * mul;
+        codeO += asO[v] * mul;
+        mul *= 3;
+    }
+    const int32_t* table = potentialTable();
+    dir[0][d][cell] = table[codeX];
+    dir[1][d][cell] = table[codeO];
+}
+
+template <int N>
+void PotentialMap<N>::refresh(const BasicBoard<N>& board) {
+    for (int r = 0; r < N; ++r)
+        for (int c = 0; c < N; ++c)
+            for (int d = 0; d < 4; ++d) updateCell(board, r, c, d);
+}
+
+template <int N>
+void PotentialMap<N>::update(const BasicBoard<N>& board, int row, int col) {
+    for (int d = 0; d < 4; ++d) {
+        for (int i = -REACH; i <= REACH; ++i) {
+            int r = row + DIRS[d][0] * i, c = col + DIRS[d][1] * i;
+            if (r >= 0 && r < N && c >= 0 && c < N) updateCell(board, r, c, d);
+        }
+    }
+}
+
+template <int N>
+void PotentialMap<N>::combine(int mover, int32_t* out) const {
+    const int32_t(&own)[4][CELLS] = dir[mover - 1];
+    const int32_t(&opp)[4][CELLS] = dir[2 - mover];
+    for (int i = 0; i < CELLS; ++i) {
+        out[i] = 2 * (own[0][i] + own[1][i] + own[2][i] + own[3][i]) + (opp[0][i] + opp[1][i] + opp[2][i] + opp[3][i]);
+    }
+}
+
+template <int N>
+int32_t PotentialMap<N>::maxDirectional() const {
+    const int32_t* all = &dir[0][0][0];
+    int32_t best = 0;
+    for (int i = 0; i < 2 * 4 * CELLS; ++i) best = std::max(best, all[i]);
+    return best;
+}
+
+template class PotentialMap<15>;
+template class PotentialMap<19>;
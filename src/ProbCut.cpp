@@ -0,0 +1,79 @@
+#include "ProbCut.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool ProbCutParams::enabled() const {
+    for (const Pair& p : pairs)
+        if (p.shallow > 0) return true;
+    return false;
+}
+
+bool ProbCutParams::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    ProbCutParams loaded;
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key) || key[0] == '#') continue;
+        bool ok;
+        if (key == "threshold") {
+            ok = static_cast<bool>(fields >> loaded.threshold) && loaded.threshold >= 0;
+        } else if (key == "quiet_limit") {
+            ok = static_cast<bool>(fields >> loaded.quietLimit);
+        } else if (key == "depth") {
+            int depth;
+            Pair p;
+            ok = static_cast<bool>(fields >> depth >> p.shallow >> p.a >> p.b >> p.sigma) && depth >= 2 &&
+                 depth <= MAX_DEPTH && p.shallow >= 1 && p.shallow < depth && p.a > 0 && p.sigma >= 0;
+            if (ok) loaded.pairs[depth] = p;
+        } else {
+            std::cerr << path << ":" << lineNo << ": unknown key " << key << "\n";
+            return false;
+        }
+        if (!ok) {
+            std::cerr << path << ":" << lineNo << ": invalid " << key << "\n";
+            return false;
+        }
+    }
+    *this = loaded;
+    return true;
+}
+
+bool ProbCutParams::save(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "# ProbCut：深度 d 以淺層 shallow 預測，deep = a * shallow + b，殘差標準差 sigma\n";
+    out << "threshold " << threshold << "\n";
+    out << "quiet_limit " << quietLimit << "\n";
+    out << "# depth d shallow a b sigma\n";
+    for (int d = 0; d <= MAX_DEPTH; ++d) {
+        const Pair& p = pairs[d];
+        if (p.shallow > 0) out << "depth " << d << " " << p.shallow << " " << p.a << " " << p.b << " " << p.sigma << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+uint64_t ProbCutParams::fingerprint() const {
+    if (!enabled()) return 0;
+    uint64_t h = 1469598103934665603ULL; // FNV-1a
+    auto mix = [&](const void* data, size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    mix(&threshold, sizeof(threshold));
+    mix(&quietLimit, sizeof(quietLimit));
+    for (const Pair& p : pairs) {
+        mix(&p.shallow, sizeof(p.shallow));
+        mix(&p.a, sizeof(p.a));
+        mix(&p.b, sizeof(p.b));
+        mix(&p.sigma, sizeof(p.sigma));
+    }
+    return h;
+}
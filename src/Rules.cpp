@@ -0,0 +1,111 @@
+#include "Rules.hpp"
+#include <algorithm>
+
+// 以下都在 11 格的線上運作：cells[5] 為落子點，0 空、1 己方、2 擋住
+static const int LINE = 11;
+static const int CENTER = 5;
+
+static int runThroughCenter(const int* cells) {
+    if (cells[CENTER] != 1) return 0;
+    int count = 1;
+    for (int i = CENTER - 1; i >= 0 && cells[i] == 1; --i) count++;
+    for (int i = CENTER + 1; i < LINE && cells[i] == 1; ++i) count++;
+    return count;
+}
+
+// 補一子就恰好五連（且經過中心）的空點，只考慮中心前後 4 格以內
+static int fivePoints(int* cells, int* points) {
+    int n = 0;
+    for (int e = 1; e < LINE - 1; ++e) {
+        if (cells[e] != 0) continue;
+        cells[e] = 1;
+        if (runThroughCenter(cells) == 5) points[n++] = e;
+        cells[e] = 0;
+    }
+    return n;
+}
+
+// 活四：連續四子且兩端補上都恰好成五
+static bool isStraightFour(int* cells) {
+    int points[LINE];
+    return fivePoints(cells, points) == 2 && points[1] - points[0] == 5;
+}
+
+static uint8_t classify(int* cells) {
+    int run = runThroughCenter(cells);
+    if (run == 5) return LinePatterns::FIVE;
+    if (run > 5) return LinePatterns::OVERLINE;
+
+    // 兩個成五點剛好是同一個活四的兩端時只算一個四，其餘（如 X.XXX.X）算兩個
+    int points[LINE];
+    int n = fivePoints(cells, points);
+    int fours = (n == 2 && points[1] - points[0] == 5) ? 1 : std::min(n, 2);
+    if (fours > 0) return static_cast<uint8_t>(fours << 3);
+
+    // 活三：再補一子就能形成經過中心的活四
+    for (int e = 1; e < LINE - 1; ++e) {
+        if (cells[e] != 0) continue;
+        cells[e] = 1;
+        bool straight = runThroughCenter(cells) < 5 && isStraightFour(cells);
+        cells[e] = 0;
+        if (straight) return LinePatterns::THREE;
+    }
+    return 0;
+}
+
+const uint8_t* LinePatterns::table() {
+    static const struct Table {
+        uint8_t patterns[CODES];
+        Table() {
+            for (int code = 0; code < CODES; ++code) {
+                int cells[LINE];
+                int rest = code;
+                for (int i = 0; i < LINE; ++i) {
+                    if (i == CENTER) continue;
+                    cells[i] = rest % 3;
+                    rest /= 3;
+                }
+                cells[CENTER] = 1;
+                patterns[code] = classify(cells);
+            }
+        }
+    } instance;
+    return instance.patterns;
+}
+
+// --- LineCodes --- //
+
+// 鄰格在 encode 裡的位數：offset -5..-1 為 0..4，1..5 為 5..9
+static const int POW3[10] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561, 19683};
+static const int (&DIRS)[4][2] = LinePatterns::DIRS;
+
+template <int N>
+void LineCodes<N>::refresh(const BasicBoard<N>& board) {
+    for (int r = 0; r < N; ++r)
+        for (int c = 0; c < N; ++c) {
+            digits[r * N + c] = static_cast<uint8_t>(board.cellCode(r, c));
+            for (int d = 0; d < 4; ++d)
+                codes[d][r * N + c] = static_cast<uint16_t>(LinePatterns::encode(board, r, c, DIRS[d][0], DIRS[d][1], 1));
+        }
+}
+
+template <int N>
+void LineCodes<N>::update(const BasicBoard<N>& board, int row, int col) {
+    const int cell = row * N + col;
+    const int now = board.cellCode(row, col);
+    const int delta = now - digits[cell]; // cellCode 的 1 = X、2 = O 恰好就是黑棋角度的位值
+    if (delta == 0) return;
+    digits[cell] = static_cast<uint8_t>(now);
+    for (int d = 0; d < 4; ++d) {
+        for (int i = -5; i <= 5; ++i) {
+            if (i == 0) continue;
+            // (row, col) 位在 t 的 offset i 處
+            int r = row - DIRS[d][0] * i, c = col - DIRS[d][1] * i;
+            if (r < 0 || r >= N || c < 0 || c >= N) continue;
+            codes[d][r * N + c] = static_cast<uint16_t>(codes[d][r * N + c] + delta * POW3[i < 0 ? i + 5 : i + 4]);
+        }
+    }
+}
+
+template class LineCodes<15>;
+template class LineCodes<19>;
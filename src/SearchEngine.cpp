@@ -0,0 +1,708 @@
+#include "SearchEngine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+template <int N, class Rule>
+SearchEngine<N, Rule>::SearchEngine(char symbol, size_t ttSizeMB)
+    : symbol(symbol), transpositionTable(ttSizeMB) {
+    opponentSymbol = (symbol == 'X') ? 'O' : 'X';
+    sign = (symbol == 'X') ? 1 : -1;
+}
+
+template <int N, class Rule>
+SymmetricHash<N> SearchEngine<N, Rule>::computeZobristHash(const BoardType& board) const {
+    return hashPosition(board);
+}
+
+template <int N, class Rule>
+bool SearchEngine<N, Rule>::setNetwork(const NnueNetwork* net) {
+    if (net && (!net->isLoaded() || net->boardSize() != N)) return false;
+    if (net != network) evalCache.clear();
+    network = net;
+    return true;
+}
+
+template <int N, class Rule>
+int SearchEngine<N, Rule>::evaluateLeaf(BoardType& board, const Accumulator* acc) {
+    if (acc) return sign * network->evaluate(*acc);
+    return evaluateBoard(board);
+}
+
+template <int N, class Rule>
+int SearchEngine<N, Rule>::evaluateCached(BoardType& board, const Accumulator* acc, uint64_t key) {
+    evalProbes.fetch_add(1, std::memory_order_relaxed);
+    int score;
+    if (evalCache.probe(key, score)) {
+        evalHits.fetch_add(1, std::memory_order_relaxed);
+        return score;
+    }
+    score = evaluateLeaf(board, acc);
+    evalCache.store(key, score);
+    return score;
+}
+
+template <int N, class Rule>
+int SearchEngine<N, Rule>::evaluateBoard(BoardType& board) {
+    if (network) { // 沒有現成的累加器時從頭算一次
+        Accumulator acc;
+        network->refresh(board, acc);
+        return sign * network->evaluate(acc);
+    }
+
+    int score = 0;
+    uint8_t line[N], diag2[N]; // 掃描用暫存，放在堆疊上
+
+    // 橫列與直行：長度固定為 N，迴圈在編譯期即可展開
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) line[j] = board.cellCode(i, j);
+        score += patterns.evaluateLine(line, N);
+        for (int j = 0; j < N; ++j) line[j] = board.cellCode(j, i);
+        score += patterns.evaluateLine(line, N);
+    }
+
+    // 對角線（長度不足 5 的略過）
+    for (int k = 4; k <= 2 * (N - 1) - 4; ++k) {
+        int n1 = 0, n2 = 0;
+        for (int i = 0; i < N; ++i) {
+            int j1 = k - i;
+            int j2 = i - (k - N + 1);
+            if (j1 >= 0 && j1 < N) line[n1++] = board.cellCode(i, j1);
+            if (j2 >= 0 && j2 < N) diag2[n2++] = board.cellCode(i, j2);
+        }
+        score += patterns.evaluateLine(line, n1);
+        score += patterns.evaluateLine(diag2, n2);
+    }
+
+    return sign * score; // 轉成引擎自己的角度（加入防守視角）
+}
+
+
+// --- 只產生鄰近已下棋子的空格（效率優化） --- //
+// 有禁手的規則另外濾掉 mover 不能下的點
+template <int N, class Rule>
+void SearchEngine<N, Rule>::generateMoves(BoardType& board, MoveList& moves, char mover, const LineCodes<N>* lines) {
+    moves.clear();
+
+    const int range = 1;
+
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            if (board.getCell(i, j) != '.') continue;
+
+            for (int dx = -range; dx <= range; ++dx) {
+                for (int dy = -range; dy <= range; ++dy) {
+                    int ni = i + dx, nj = j + dy;
+                    if (ni >= 0 && ni < N && nj >= 0 && nj < N &&
+                        board.getCell(ni, nj) != '.') {
+                        if (!Rule::hasForbidden ||
+                            !(lines ? Rule::isForbidden(*lines, i, j, mover) : Rule::isForbidden(board, i, j, mover)))
+                            moves.emplace_back(i, j);
+                        goto next;
+                    }
+                }
+            }
+        next:;
+        }
+    }
+}
+
+// 依潛力圖由高到低排序（first 固定排第一，通常是置換表的最佳步），再截成這一層的寬度
+template <int N, class Rule>
+void SearchEngine<N, Rule>::orderMoves(MoveList& moves, const PotentialMap<N>& potential, char mover, std::pair<int, int> first,
+                                       int ply) const {
+    int32_t scores[N * N];
+    potential.combine(mover == 'X' ? 1 : 2, scores);
+    if (first.first >= 0) scores[first.first * N + first.second] = std::numeric_limits<int32_t>::max();
+
+    // 等同依分數 stable_sort，但 stable_sort 每次都會向堆積要暫存緩衝：
+    // 把（分數、原本的順序、格子）壓成一個 64 位元鍵，在堆疊上用 std::sort 由大到小排
+    uint64_t keys[N * N];
+    const int count = moves.size();
+    for (int i = 0; i < count; ++i) {
+        const int cell = moves[i].first * N + moves[i].second;
+        const uint32_t score = static_cast<uint32_t>(scores[cell]) ^ 0x80000000u; // 有號轉成無號後大小順序不變
+        keys[i] = (uint64_t(score) << 32) | (uint64_t(0xFFFF - i) << 16) | uint64_t(cell);
+    }
+    std::sort(keys, keys + count, std::greater<uint64_t>());
+    for (int i = 0; i < count; ++i) {
+        const int cell = static_cast<int>(keys[i] & 0xFFFF);
+        moves[i] = {cell / N, cell % N};
+    }
+
+    if (!moveWidths.empty()) {
+        int width = moveWidths[std::min<size_t>(ply, moveWidths.size() - 1)];
+        if (width > 0) moves.truncate(width);
+    }
+}
+
+template <int N, class Rule>
+bool SearchEngine<N, Rule>::outOfTime() {
+    if (timeUp.load(std::memory_order_relaxed)) return true;
+    if (std::chrono::steady_clock::now() > deadline || (stopFlag && stopFlag->load(std::memory_order_relaxed))) {
+        timeUp.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// --- Minimax + Alpha-Beta + Zobrist Transposition Table --- //
+// 每個執行緒各自持有一份 Board，以落子/還原走訪；走法清單放在堆疊上
+template <int N, class Rule>
+int SearchEngine<N, Rule>::minimax(BoardType& board, int depth, bool maximizing, int alpha, int beta, const SymmetricHash<N>& hash,
+                                   const Accumulator* acc, PotentialMap<N>& potential, LineCodes<N>& lines, int ply,
+                                   SearchTrace::Writer* trace) {
+    nodes.fetch_add(1, std::memory_order_relaxed);
+    uint8_t traceFlags = maximizing ? SearchTrace::MAXIMIZING : 0;
+    int searched = 0;
+    // 追蹤時在每個返回點記下結果與原因；沒開追蹤時只多一次指標判斷
+    auto leave = [&](int score, SearchTrace::Reason reason) {
+        if (trace) trace->exit(score, reason, traceFlags, searched);
+        return score;
+    };
+    if (outOfTime()) {
+        return leave(evaluateLeaf(board, acc), SearchTrace::TIMEOUT);  // 超過時間限制，直接返回評分
+    }
+
+    const int alphaOrig = alpha, betaOrig = beta;
+
+    // 檢查轉置表（以 8 種對稱中最小的雜湊為鍵，存的走法也換算到標準形座標）
+    int sym;
+    const uint64_t key = hash.canonical(sym);
+    TranspositionTable::Entry entry;
+    bool hit = transpositionTable.probe(key, entry);
+    if (hit) {
+        traceFlags |= SearchTrace::TT_HIT;
+        ttHits.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (hit && entry.depth >= depth) {
+        if (entry.bound == TranspositionTable::EXACT) return leave(entry.score, SearchTrace::TT_CUT);
+        if (entry.bound == TranspositionTable::LOWER && entry.score >= beta) return leave(entry.score, SearchTrace::TT_CUT);
+        if (entry.bound == TranspositionTable::UPPER && entry.score <= alpha) return leave(entry.score, SearchTrace::TT_CUT);
+    }
+
+    // 葉節點的評估只進評估快取，不佔置換表。棋型評估對 8 種對稱不變，與置換表共用標準形的鍵；
+    // 網路評估不一定對稱，改用原局面的雜湊
+    if (depth == 0 || board.isFull()) return leave(evaluateCached(board, acc, network ? hash.h[0] : key), SearchTrace::LEAF);
+
+    int cut;
+    if (tryProbCut(board, depth, maximizing, alpha, beta, hash, acc, potential, lines, ply, cut)) return leave(cut, SearchTrace::PROBCUT);
+
+    const char mover = maximizing ? symbol : opponentSymbol;
+    MoveList moves;
+    generateMoves(board, moves, mover, &lines);
+
+    // 轉置表記錄的最佳步優先搜尋，其餘依潛力圖排序
+    std::pair<int, int> ttMove = {-1, -1};
+    if (hit && entry.row >= 0) ttMove = applySymmetry<N>(inverseSymmetry(sym), entry.row, entry.col);
+    orderMoves(moves, potential, mover, ttMove, ply);
+
+    int bestVal = maximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+    std::pair<int, int> bestMove = {-1, -1};
+    Accumulator child; // 網路評估時：複製後加上一列權重即為子節點的累加器
+
+    SearchTrace::Reason reason = SearchTrace::EXHAUSTED;
+    for (auto [r, c] : moves) {
+        board.placePiece(r, c, mover);
+        searched++;
+        if (trace) trace->enter(ply + 1, r, c, depth - 1, alpha, beta);
+
+        int score;
+        if (Rule::isWin(board, r, c, mover)) {
+            score = maximizing ? 100000 : -100000;
+            board.removePiece(r, c);
+            if (trace) trace->exit(score, SearchTrace::WIN, maximizing ? 0 : SearchTrace::MAXIMIZING, 0);
+        } else {
+            if (acc) {
+                child = *acc;
+                network->add(child, r * N + c, mover == 'X' ? 0 : 1);
+            }
+            const bool track = depth > 1; // 子節點是葉節點時用不到潛力圖與單線編碼
+            if (track) updateLocal(board, r, c, potential, lines);
+            score = minimax(board, depth - 1, !maximizing, alpha, beta, hash.with(r, c, mover), acc ? &child : nullptr,
+                            potential, lines, ply + 1, trace);
+            board.removePiece(r, c);
+            if (track) updateLocal(board, r, c, potential, lines);
+        }
+
+        if (maximizing ? score > bestVal : score < bestVal) {
+            bestVal = score;
+            bestMove = {r, c};
+        }
+        if (maximizing) {
+            alpha = std::max(alpha, bestVal);
+        } else {
+            beta = std::min(beta, bestVal);
+        }
+        if (beta <= alpha) {
+            reason = SearchTrace::CUTOFF;
+            break;
+        }
+    }
+
+    // 時間到時的結果不完整，不寫入轉置表
+    if (timeUp.load(std::memory_order_relaxed)) return leave(bestVal, SearchTrace::TIMEOUT);
+
+    // 存儲最終結果到轉置表
+    TranspositionTable::Bound bound = TranspositionTable::EXACT;
+    if (bestVal <= alphaOrig) bound = TranspositionTable::UPPER;
+    else if (bestVal >= betaOrig) bound = TranspositionTable::LOWER;
+    if (bestMove.first >= 0) bestMove = applySymmetry<N>(sym, bestMove.first, bestMove.second);
+    transpositionTable.store(key, bestVal, depth, bound, bestMove.first, bestMove.second);
+    return leave(bestVal, reason);
+}
+
+
+// ProbCut：深層結果 ≈ a * 淺層結果 + b。要確定深層結果 >= beta，只需淺層結果 >= (beta + t·sigma - b) / a，
+// 以這個界線做一次零窗口的淺層搜尋即可判斷；alpha 那一側同理。
+// 有人能成活四或五時（潛力圖判斷）不剪，讓強制變化照常搜完；勝負分數附近的窗口也不剪
+template <int N, class Rule>
+bool SearchEngine<N, Rule>::tryProbCut(BoardType& board, int depth, bool maximizing, int alpha, int beta,
+                                       const SymmetricHash<N>& hash, const Accumulator* acc, PotentialMap<N>& potential,
+                                       LineCodes<N>& lines, int ply, int& result) {
+    const ProbCutParams::Pair* pc = probCut.at(depth);
+    if (!pc || potential.maxDirectional() >= probCut.quietLimit) return false;
+
+    const int WIN = 100000;
+    const double margin = probCut.threshold * pc->sigma;
+    if (beta < WIN) {
+        double bound = std::ceil((beta + margin - pc->b) / pc->a);
+        if (bound > -WIN && bound < WIN) {
+            int b = static_cast<int>(bound);
+            int v = minimax(board, pc->shallow, maximizing, b - 1, b, hash, acc, potential, lines, ply, nullptr);
+            if (timeUp.load(std::memory_order_relaxed)) return false;
+            if (v >= b) {
+                probCuts.fetch_add(1, std::memory_order_relaxed);
+                result = beta;
+                return true;
+            }
+        }
+    }
+    if (alpha > -WIN) {
+        double bound = std::floor((alpha - margin - pc->b) / pc->a);
+        if (bound > -WIN && bound < WIN) {
+            int a = static_cast<int>(bound);
+            int v = minimax(board, pc->shallow, maximizing, a, a + 1, hash, acc, potential, lines, ply, nullptr);
+            if (timeUp.load(std::memory_order_relaxed)) return false;
+            if (v <= a) {
+                probCuts.fetch_add(1, std::memory_order_relaxed);
+                result = alpha;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 根節點平行化：固定數量的工作執行緒輪流領取根節點走法，
+// 每個執行緒在自己的 Board 副本上搜尋，結果寫入 scores（與 moves 同順序）
+template <int N, class Rule>
+void SearchEngine<N, Rule>::scoreRootMoves(const BoardType& board, const MoveList& moves, int depth, int* scores) {
+    int workerCount = std::min<int>(threadLimit, std::max(1u, std::thread::hardware_concurrency()));
+    workerCount = std::max(1, workerCount);
+    workerCount = std::min(workerCount, moves.size());
+
+    std::atomic<int> nextIndex{0};
+
+    // 追蹤時這一層算一次搜尋，各執行緒用自己的緩衝寫入器
+    uint32_t traceSearch = 0;
+    if (trace) {
+        std::vector<std::pair<int, char>> stones;
+        for (int r = 0; r < N; ++r)
+            for (int c = 0; c < N; ++c)
+                if (board.getCell(r, c) != '.') stones.emplace_back(r * N + c, board.getCell(r, c));
+        traceSearch = trace->beginSearch(stones, depth, symbol);
+    }
+
+    auto worker = [&](int thread) {
+        std::optional<SearchTrace::Writer> writer;
+        if (trace) writer.emplace(*trace, traceSearch, static_cast<uint16_t>(thread));
+        SearchTrace::Writer* out = writer ? &*writer : nullptr;
+        BoardType copy = board;
+        const SymmetricHash<N> rootHash = computeZobristHash(copy);
+        Accumulator rootAcc, child;
+        if (network) network->refresh(copy, rootAcc);
+        PotentialMap<N> potential;
+        potential.refresh(copy);
+        LineCodes<N> lines;
+        if (Rule::hasForbidden) lines.refresh(copy);
+        for (int i = nextIndex++; i < moves.size(); i = nextIndex++) {
+            auto [r, c] = moves[i];
+            copy.placePiece(r, c, symbol);
+            if (network) {
+                child = rootAcc;
+                network->add(child, r * N + c, symbol == 'X' ? 0 : 1);
+            }
+            if (depth > 0) updateLocal(copy, r, c, potential, lines);
+            if (out) out->enter(1, r, c, depth, std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+            scores[i] = minimax(copy, depth, false, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(),
+                                rootHash.with(r, c, symbol), network ? &child : nullptr, potential, lines, 1, out);
+            copy.removePiece(r, c);
+            if (depth > 0) updateLocal(copy, r, c, potential, lines);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount - 1);
+    for (int t = 1; t < workerCount; ++t) {
+        threads.emplace_back([&, t]() {
+            if (pinThreads) pinCurrentThread(t);
+            worker(t);
+        });
+    }
+    worker(0);
+    for (auto& t : threads) t.join();
+}
+
+template <int N, class Rule>
+SearchResult SearchEngine<N, Rule>::findBestMove(BoardType& board) {
+    SearchResult result;
+
+    // 1. 優先檢查是否有可以獲勝的步驟
+    auto winningMove = findWinningMoveIfAvailable(board);
+    if (winningMove) {
+        result.move = *winningMove;  // 如果有獲勝步驟，直接返回
+        result.score = 100000;
+        result.source = "win";
+        return result;
+    }
+
+    // 2. 優先阻止對手的四連或三連威脅
+    auto blockingMove = findBlockingMoveIfThreat(board);
+    if (blockingMove) {
+        result.move = *blockingMove;  // 如果有阻止對手的步驟，返回
+        board.placePiece(blockingMove->first, blockingMove->second, symbol);
+        result.score = evaluateBoard(board);
+        board.removePiece(blockingMove->first, blockingMove->second);
+        result.source = "block";
+        return result;
+    }
+
+    // 3. 沒有威脅時：使用 minimax + evaluateBoard() 找最好的進攻位置
+    MoveList moves;
+    generateMoves(board, moves, symbol);
+    if (moves.empty()) {
+        result.move = fallbackMove(board);
+        if (result.move.first < 0) result.source = "none";
+        return result;
+    }
+    PotentialMap<N> potential;
+    potential.refresh(board);
+    orderMoves(moves, potential, symbol, {-1, -1}, 0);
+
+    int scores[N * N];
+    scoreRootMoves(board, moves, searchDepth, scores);
+
+    result.score = std::numeric_limits<int>::min();
+    result.move = moves[0];
+    for (int i = 0; i < moves.size(); ++i) {
+        if (scores[i] > result.score) {
+            result.score = scores[i];
+            result.move = moves[i];
+        }
+    }
+
+    return result;
+}
+
+// 沒有候選步時：空棋盤、或連珠黑棋在棋子周圍全是禁手。下離天元最近的合法空點（空棋盤即天元），
+// 一個都沒有就回傳 {-1, -1}
+template <int N, class Rule>
+std::pair<int, int> SearchEngine<N, Rule>::fallbackMove(const BoardType& board) const {
+    std::pair<int, int> best = {-1, -1};
+    int bestDistance = std::numeric_limits<int>::max();
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            if (board.cellCode(r, c) != 0 || Rule::isForbidden(board, r, c, symbol)) continue;
+            int distance = std::max(std::abs(r - N / 2), std::abs(c - N / 2));
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = {r, c};
+            }
+        }
+    }
+    return best;
+}
+
+// 從根節點的最佳步開始，沿著置換表記錄的最佳步走出主要變化
+template <int N, class Rule>
+void SearchEngine<N, Rule>::extractPV(BoardType board, SearchResult& result) {
+    result.pv.clear();
+    if (result.move.first < 0) return;
+
+    char mover = symbol;
+    std::pair<int, int> move = result.move;
+    SymmetricHash<N> hash = computeZobristHash(board);
+    for (int ply = 0; ply <= searchDepth; ++ply) {
+        if (!board.placePiece(move.first, move.second, mover)) break;
+        result.pv.push_back(move);
+        if (Rule::isWin(board, move.first, move.second, mover)) break;
+        hash.toggle(move.first, move.second, mover);
+        mover = (mover == 'X') ? 'O' : 'X';
+
+        int sym;
+        TranspositionTable::Entry entry;
+        if (!transpositionTable.probe(hash.canonical(sym), entry) || entry.row < 0) break;
+        move = applySymmetry<N>(inverseSymmetry(sym), entry.row, entry.col);
+    }
+}
+
+
+
+
+
+template <int N, class Rule>
+bool SearchEngine<N, Rule>::hasDangerousThree(BoardType& board, char checkSymbol) {
+    const int SIZE = N;
+    auto isValid = [&](int r, int c) {
+        return r >= 0 && r < SIZE && c >= 0 && c < SIZE;
+    };
+
+    auto checkPattern = [&](int r, int c, int dr, int dc) {
+        std::string line;
+        for (int i = -1; i <= 4; ++i) {  // 掃 6 格長的區段，涵蓋中間空格情形
+            int nr = r + dr * i;
+            int nc = c + dc * i;
+            if (!isValid(nr, nc)) {
+                line += " ";  // 邊界算阻擋
+            } else {
+                line += board.getCell(nr, nc);
+            }
+        }
+
+        // 危險三連模式：中間插空或兩端都空的三個連續棋子
+        return (line.find(".XXX.") != std::string::npos ||
+                line.find("X.XX")  != std::string::npos ||
+                line.find("XX.X")  != std::string::npos);
+    };
+
+    for (int i = 0; i < SIZE; ++i) {
+        for (int j = 0; j < SIZE; ++j) {
+            if (board.getCell(i, j) != checkSymbol) continue;
+
+            // 檢查四個方向：橫、直、斜（↘）、反斜（↙）
+            if (checkPattern(i, j, 0, 1) ||     // →
+                checkPattern(i, j, 1, 0) ||     // ↓
+                checkPattern(i, j, 1, 1) ||     // ↘
+                checkPattern(i, j, 1, -1)) {    // ↙
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+template <int N, class Rule>
+std::optional<std::pair<int, int>> SearchEngine<N, Rule>::findBlockingMoveIfThreat(BoardType& board) {
+    static const std::pair<int, int> dirs[4] = {{0,1}, {1,0}, {1,1}, {1,-1}};
+
+    auto checkLine = [&](int startR, int startC, int dr, int dc, int length) -> std::optional<std::pair<int, int>> {
+        int count = 0;
+        std::pair<int, int> emptySpot = {-1, -1};
+
+        for (int i = 0; i < length; ++i) {
+            int r = startR + i * dr;
+            int c = startC + i * dc;
+            if (r < 0 || r >= N || c < 0 || c >= N)
+                return std::nullopt;
+
+            char cell = board.getCell(r, c);
+            if (cell == opponentSymbol) {
+                count++;
+            } else if (cell == '.') {
+                if (emptySpot.first == -1)
+                    emptySpot = {r, c};
+                else
+                    return std::nullopt; // 多於一個空格，不算連線威脅
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        if ((length == 5 && count == 4) || (length == 4 && count == 3)) {
+            if (Rule::isForbidden(board, emptySpot.first, emptySpot.second, symbol)) return std::nullopt;
+            return emptySpot;
+        }
+
+        return std::nullopt;
+    };
+
+    // 優先檢查 4 連（5 格中有一空）=> 急需阻止
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            for (auto [dr, dc] : dirs) {
+                auto move = checkLine(r, c, dr, dc, 5);
+                if (move) return move;
+            }
+        }
+    }
+
+    // 若無，再檢查 3 連（4 格中有一空）=> 提前防守
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            for (auto [dr, dc] : dirs) {
+                auto move = checkLine(r, c, dr, dc, 4);
+                if (move) return move;
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+
+template <int N, class Rule>
+std::optional<std::pair<int, int>> SearchEngine<N, Rule>::findWinningMoveIfAvailable(BoardType& board) {
+    MoveList moves;
+    generateMoves(board, moves, symbol);
+
+    for (auto& move : moves) {
+        auto [r, c] = move;
+        board.placePiece(r, c, symbol);  // 嘗試這步驟
+        bool win = Rule::isWin(board, r, c, symbol);
+        board.removePiece(r, c);
+
+        if (win) {
+            return move;  // 如果這步驟可以獲勝，返回
+        }
+    }
+
+    return std::nullopt;  // 如果沒有獲勝的步驟，返回 nullopt
+}
+
+
+template <int N, class Rule>
+std::pair<int, int> SearchEngine<N, Rule>::search(BoardType& board) {
+    return analyze(board).move;
+}
+
+template <int N, class Rule>
+SearchResult SearchEngine<N, Rule>::analyze(BoardType& board) {
+    auto start = std::chrono::steady_clock::now();
+
+    // 開局庫有這個局面就直接照著下
+    if (book) {
+        auto bookMove = book->probe<Rule>(board, symbol);
+        if (bookMove) {
+            SearchResult result;
+            result.move = *bookMove;
+            result.pv.push_back(*bookMove);
+            result.source = "book";
+            return result;
+        }
+    }
+
+    deadline = start + maxTime;
+    timeUp = false;
+    nodes = 0;
+    evalProbes = 0;
+    evalHits = 0;
+    probCuts = 0;
+    ttHits = 0;
+    if (!keepTable && !transpositionTable.isPersistent()) transpositionTable.clear(); // 每次重新開始
+
+    SearchResult result = findBestMove(board);
+    result.nodes = nodes.load();
+    result.evalProbes = evalProbes.load();
+    result.evalHits = evalHits.load();
+    result.probCuts = probCuts.load();
+    result.ttHits = ttHits.load();
+    extractPV(board, result);
+    result.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// 反覆加深：每一層都給所有根節點走法完整的搜尋窗口，分數彼此可比，直接取前 k 名
+// 時間到時丟棄沒做完的那一層，保留上一層的結果
+template <int N, class Rule>
+std::vector<SearchResult> SearchEngine<N, Rule>::analyzeMultiPV(BoardType& board, int k, const MultiPVCallback& onUpdate) {
+    auto start = std::chrono::steady_clock::now();
+    deadline = start + maxTime;
+    timeUp = false;
+    nodes = 0;
+    evalProbes = 0;
+    evalHits = 0;
+    probCuts = 0;
+    ttHits = 0;
+    if (!keepTable && !transpositionTable.isPersistent()) transpositionTable.clear();
+
+    std::vector<SearchResult> best;
+    MoveList moves;
+    generateMoves(board, moves, symbol);
+    if (moves.empty()) {
+        SearchResult only;
+        only.move = fallbackMove(board);
+        if (only.move.first < 0) only.source = "none";
+        else only.pv.push_back(only.move);
+        best.push_back(only);
+        if (onUpdate) onUpdate(best, 0);
+        return best;
+    }
+    PotentialMap<N> potential;
+    potential.refresh(board);
+    orderMoves(moves, potential, symbol, {-1, -1}, 0);
+
+    int scores[N * N];
+    int order[N * N];
+    for (int depth = 0; depth <= searchDepth; ++depth) {
+        scoreRootMoves(board, moves, depth, scores);
+        if (timeUp && !best.empty()) break;
+
+        for (int i = 0; i < moves.size(); ++i) order[i] = i;
+        std::stable_sort(order, order + moves.size(), [&](int a, int b) { return scores[a] > scores[b]; });
+
+        // 下一層照這一層的分數排序，較好的走法先搜
+        MoveList sorted;
+        for (int i = 0; i < moves.size(); ++i) sorted.push_back(moves[order[i]]);
+
+        best.clear();
+        long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        for (int i = 0; i < std::min(k, moves.size()); ++i) {
+            SearchResult line;
+            line.move = moves[order[i]];
+            line.score = scores[order[i]];
+            line.nodes = nodes.load();
+            line.evalProbes = evalProbes.load();
+            line.evalHits = evalHits.load();
+            line.probCuts = probCuts.load();
+            line.ttHits = ttHits.load();
+            line.elapsedMs = elapsed;
+            extractPV(board, line);
+            best.push_back(std::move(line));
+        }
+        moves = sorted;
+        if (onUpdate) onUpdate(best, depth);
+        if (timeUp) break;
+    }
+    return best;
+}
+
+// 存檔的指紋：棋盤大小、規則、執子方或 Zobrist 表不同時，舊的分數就不能用
+template <int N, class Rule>
+bool SearchEngine<N, Rule>::attachTableFile(const std::string& path) {
+    uint64_t signature = 1469598103934665603ULL; // FNV-1a
+    auto mix = [&](uint64_t v) {
+        signature ^= v;
+        signature *= 1099511628211ULL;
+    };
+    mix(N);
+    mix(static_cast<uint64_t>(symbol));
+    for (const char* p = Rule::name; *p; ++p) mix(static_cast<uint64_t>(*p));
+    mix(zobristKeys<N>.key[0][0][0]);
+    for (int v : weights.value) mix(static_cast<uint64_t>(static_cast<uint32_t>(v))); // 換了權重，舊分數就不能用
+    if (network) mix(network->fingerprint());
+    for (int w : moveWidths) mix(static_cast<uint64_t>(w)); // 剪枝寬度不同，分數也不同
+    mix(probCut.fingerprint());
+    return transpositionTable.attach(path, signature);
+}
+
+template class SearchEngine<15, FreestyleRule>;
+template class SearchEngine<19, FreestyleRule>;
+template class SearchEngine<15, StandardRule>;
+template class SearchEngine<19, StandardRule>;
+template class SearchEngine<15, RenjuRule>;
+template class SearchEngine<19, RenjuRule>;
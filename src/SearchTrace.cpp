@@ -0,0 +1,177 @@
+#include "SearchTrace.hpp"
+#include <cstring>
+
+static const char TRACE_MAGIC[8] = {'G', 'M', 'K', 'T', 'R', 'C', '1', '\0'};
+static const size_t WRITER_BUFFER = 64 * 1024;
+
+static void put16(unsigned char* p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
+
+static void put32(unsigned char* p, uint32_t v) {
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+static uint32_t get16(const unsigned char* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get32(const unsigned char* p) {
+    return get16(p) | (get16(p + 2) << 16);
+}
+
+// --- 寫入 --- //
+
+SearchTrace::~SearchTrace() {
+    close();
+}
+
+bool SearchTrace::open(const std::string& path, int boardSize) {
+    close();
+    out = std::fopen(path.c_str(), "wb");
+    if (!out) return false;
+    unsigned char header[FILE_HEADER_SIZE] = {};
+    std::memcpy(header, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header[8] = static_cast<unsigned char>(boardSize);
+    std::fwrite(header, 1, sizeof(header), out);
+    nextSearch = 0;
+    return true;
+}
+
+void SearchTrace::close() {
+    if (out) std::fclose(out);
+    out = nullptr;
+}
+
+uint32_t SearchTrace::beginSearch(const std::vector<std::pair<int, char>>& stones, int depth, char mover) {
+    std::vector<unsigned char> data(5 + stones.size() * 3);
+    data[0] = SEARCH;
+    data[1] = static_cast<unsigned char>(depth);
+    data[2] = static_cast<unsigned char>(mover);
+    put16(&data[3], static_cast<uint32_t>(stones.size()));
+    for (size_t i = 0; i < stones.size(); ++i) {
+        put16(&data[5 + i * 3], static_cast<uint32_t>(stones[i].first));
+        data[7 + i * 3] = static_cast<unsigned char>(stones[i].second);
+    }
+
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = nextSearch++;
+    }
+    writeChunk(id, SEARCH_THREAD, data.data(), data.size());
+    return id;
+}
+
+void SearchTrace::writeChunk(uint32_t search, uint16_t thread, const unsigned char* data, size_t length) {
+    unsigned char header[CHUNK_HEADER_SIZE] = {};
+    put32(header, search);
+    put16(header + 4, thread);
+    put32(header + 8, static_cast<uint32_t>(length));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!out) return;
+    std::fwrite(header, 1, sizeof(header), out);
+    std::fwrite(data, 1, length, out);
+}
+
+SearchTrace::Writer::Writer(SearchTrace& trace, uint32_t search, uint16_t thread)
+    : trace(trace), search(search), thread(thread), buffer(WRITER_BUFFER) {}
+
+SearchTrace::Writer::~Writer() {
+    flush();
+}
+
+void SearchTrace::Writer::flush() {
+    if (used > 0) trace.writeChunk(search, thread, buffer.data(), used);
+    used = 0;
+}
+
+// --- 讀取 --- //
+
+SearchTraceReader::~SearchTraceReader() {
+    close();
+}
+
+bool SearchTraceReader::open(const std::string& path) {
+    close();
+    in = std::fopen(path.c_str(), "rb");
+    if (!in) return false;
+    unsigned char header[SearchTrace::FILE_HEADER_SIZE];
+    if (std::fread(header, 1, sizeof(header), in) != sizeof(header) ||
+        std::memcmp(header, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        close();
+        return false;
+    }
+    size = header[8];
+    return true;
+}
+
+void SearchTraceReader::close() {
+    if (in) std::fclose(in);
+    in = nullptr;
+}
+
+bool SearchTraceReader::readHeader(uint32_t& search, uint16_t& thread, uint32_t& length) {
+    unsigned char header[SearchTrace::CHUNK_HEADER_SIZE];
+    if (!in || std::fread(header, 1, sizeof(header), in) != sizeof(header)) return false;
+    search = get32(header);
+    thread = static_cast<uint16_t>(get16(header + 4));
+    length = get32(header + 8);
+    return true;
+}
+
+bool SearchTraceReader::next(Chunk& chunk) {
+    uint32_t length;
+    if (!readHeader(chunk.search, chunk.thread, length)) return false;
+    chunk.data.resize(length);
+    return std::fread(chunk.data.data(), 1, length, in) == length;
+}
+
+bool SearchTraceReader::skip(uint32_t& search, uint16_t& thread) {
+    uint32_t length;
+    return readHeader(search, thread, length) && std::fseek(in, static_cast<long>(length), SEEK_CUR) == 0;
+}
+
+bool SearchTraceReader::parse(const std::vector<unsigned char>& data, size_t& pos, Record& record) {
+    if (pos >= data.size()) return false;
+    const unsigned char* p = data.data() + pos;
+    const size_t left = data.size() - pos;
+    record.tag = p[0];
+    switch (record.tag) {
+    case SearchTrace::ENTER:
+        if (left < 13) return false;
+        record.ply = p[1];
+        record.row = p[2];
+        record.col = p[3];
+        record.depth = static_cast<int8_t>(p[4]);
+        record.alpha = static_cast<int32_t>(get32(p + 5));
+        record.beta = static_cast<int32_t>(get32(p + 9));
+        pos += 13;
+        return true;
+    case SearchTrace::EXIT:
+        if (left < 9) return false;
+        record.reason = p[1];
+        record.flags = p[2];
+        record.children = static_cast<int>(get16(p + 3));
+        record.score = static_cast<int32_t>(get32(p + 5));
+        pos += 9;
+        return true;
+    case SearchTrace::SEARCH: {
+        if (left < 5) return false;
+        size_t count = get16(p + 3);
+        if (left < 5 + count * 3) return false;
+        record.searchDepth = p[1];
+        record.mover = static_cast<char>(p[2]);
+        record.stones.clear();
+        for (size_t i = 0; i < count; ++i)
+            record.stones.emplace_back(static_cast<int>(get16(p + 5 + i * 3)), static_cast<char>(p[7 + i * 3]));
+        pos += 5 + count * 3;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,93 @@
+#include "SparseBoard.hpp"
+#include <algorithm>
+
+SparseBoard::SparseBoard(int limit) : limit(limit) {}
+
+void SparseBoard::reset() {
+    index.clear();
+    stones.clear();
+    top = 0, bottom = -1, left = 0, right = -1;
+}
+
+bool SparseBoard::placePiece(int row, int col, char symbol) {
+    if (!inBounds(row, col) || index.count(key(row, col))) return false;
+    index[key(row, col)] = static_cast<int>(stones.size());
+    stones.push_back({row, col, symbol});
+
+    if (stones.size() == 1) {
+        top = bottom = row;
+        left = right = col;
+    } else {
+        top = std::min(top, row);
+        bottom = std::max(bottom, row);
+        left = std::min(left, col);
+        right = std::max(right, col);
+    }
+    return true;
+}
+
+void SparseBoard::removePiece(int row, int col) {
+    auto it = index.find(key(row, col));
+    if (it == index.end()) return;
+
+    // 與最後一顆交換後移除，維持 O(1)
+    int pos = it->second;
+    index.erase(it);
+    if (pos != static_cast<int>(stones.size()) - 1) {
+        stones[pos] = stones.back();
+        index[key(stones[pos].row, stones[pos].col)] = pos;
+    }
+    stones.pop_back();
+
+    // 只有拿掉外框上的棋子時才需要重算
+    if (row == top || row == bottom || col == left || col == right) recomputeBounds();
+}
+
+void SparseBoard::recomputeBounds() {
+    if (stones.empty()) {
+        top = 0, bottom = -1, left = 0, right = -1;
+        return;
+    }
+    top = bottom = stones[0].row;
+    left = right = stones[0].col;
+    for (const auto& s : stones) {
+        top = std::min(top, s.row);
+        bottom = std::max(bottom, s.row);
+        left = std::min(left, s.col);
+        right = std::max(right, s.col);
+    }
+}
+
+char SparseBoard::getCell(int row, int col) const {
+    auto it = index.find(key(row, col));
+    return it == index.end() ? '.' : stones[it->second].symbol;
+}
+
+int SparseBoard::cellCode(int row, int col) const {
+    if (!inBounds(row, col)) return 3;
+    auto it = index.find(key(row, col));
+    if (it == index.end()) return 0;
+    return stones[it->second].symbol == 'X' ? 1 : 2;
+}
+
+bool SparseBoard::isFull() const {
+    return limit > 0 && static_cast<long long>(stones.size()) == static_cast<long long>(limit) * limit;
+}
+
+bool SparseBoard::isWin(int row, int col, char symbol) const {
+    int dirs[4][2] = {{0,1},{1,0},{1,1},{1,-1}};
+    for (auto& dir : dirs) {
+        int dr = dir[0], dc = dir[1];
+        int count = 1;
+        for (int i = 1; i < 5; ++i) {
+            if (getCell(row + dr*i, col + dc*i) != symbol) break;
+            count++;
+        }
+        for (int i = 1; i < 5; ++i) {
+            if (getCell(row - dr*i, col - dc*i) != symbol) break;
+            count++;
+        }
+        if (count >= 5) return true;
+    }
+    return false;
+}
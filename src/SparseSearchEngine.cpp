@@ -0,0 +1,367 @@
+#include "SparseSearchEngine.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
+template <class Rule>
+SparseSearchEngine<Rule>::SparseSearchEngine(char symbol, size_t ttSizeMB)
+    : symbol(symbol), transpositionTable(ttSizeMB) {
+    opponentSymbol = (symbol == 'X') ? 'O' : 'X';
+    sign = (symbol == 'X') ? 1 : -1;
+}
+
+// 無邊界棋盤沒辦法預先建表，直接由座標雜湊出 Zobrist 值（splitmix64）
+template <class Rule>
+uint64_t SparseSearchEngine<Rule>::zobristKey(int row, int col, char symbol) {
+    uint64_t z = SparseBoard::key(row, col) * 2 + (symbol == 'X' ? 0 : 1) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+template <class Rule>
+uint64_t SparseSearchEngine<Rule>::computeZobristHash(const SparseBoard& board) {
+    uint64_t hash = 0;
+    for (const auto& s : board.getStones()) hash ^= zobristKey(s.row, s.col, s.symbol);
+    return hash;
+}
+
+// 只有含棋子的五格窗口才有分數：對每個方向把棋子投影到所在的線上，
+// 排序後只評估棋子附近的窗口，成本與棋子數成正比
+template <class Rule>
+int SparseSearchEngine<Rule>::evaluate(const SparseBoard& board, Worker& w) {
+    const auto& stones = board.getStones();
+    auto& scratch = w.scratch;
+    int score = 0;
+
+    for (int d = 0; d < 4; ++d) {
+        // 方向依序為 →、↓、↘、↙；線編號與線上位置：橫列以 row 編號，其餘以 row 當位置
+        scratch.clear();
+        for (const auto& s : stones) {
+            int64_t line;
+            int pos;
+            if (d == 0) { line = s.row; pos = s.col; }
+            else if (d == 1) { line = s.col; pos = s.row; }
+            else if (d == 2) { line = int64_t(s.col) - s.row; pos = s.row; }
+            else { line = int64_t(s.row) + s.col; pos = s.row; }
+            scratch.push_back({line, pos});
+        }
+        std::sort(scratch.begin(), scratch.end());
+
+        // 由位置 p 換回座標
+        auto cellAt = [&](int64_t line, int p) {
+            if (d == 0) return board.cellCode(static_cast<int>(line), p);
+            if (d == 1) return board.cellCode(p, static_cast<int>(line));
+            if (d == 2) return board.cellCode(p, static_cast<int>(line + p));
+            return board.cellCode(p, static_cast<int>(line - p));
+        };
+
+        size_t i = 0;
+        while (i < scratch.size()) {
+            const int64_t line = scratch[i].line;
+            int next = std::numeric_limits<int>::min(); // 下一個尚未評估的窗口起點
+            for (; i < scratch.size() && scratch[i].line == line; ++i) {
+                int from = std::max(next, scratch[i].pos - 4);
+                for (int start = from; start <= scratch[i].pos; ++start) {
+                    uint8_t cells[5];
+                    bool inside = true;
+                    for (int k = 0; k < 5; ++k) {
+                        int code = cellAt(line, start + k);
+                        if (code == 3) { inside = false; break; }
+                        cells[k] = static_cast<uint8_t>(code);
+                    }
+                    if (!inside) continue;
+                    bool leftOpen = cellAt(line, start - 1) == 0;
+                    bool rightOpen = cellAt(line, start + 5) == 0;
+                    score += patterns[PatternTable::index(PatternTable::window(cells), leftOpen, rightOpen)];
+                }
+                next = scratch[i].pos + 1;
+            }
+        }
+    }
+
+    return sign * score;
+}
+
+// --- 只產生鄰近已下棋子的空格 --- //
+// 有禁手的規則另外濾掉 mover 不能下的點
+template <class Rule>
+void SparseSearchEngine<Rule>::generate(const SparseBoard& board, std::vector<std::pair<int, int>>& moves, char mover,
+                                        Worker& w) {
+    moves.clear();
+    const auto& stones = board.getStones();
+    if (stones.empty()) {
+        int center = board.getLimit() > 0 ? board.getLimit() / 2 : 0;
+        moves.emplace_back(center, center);
+        return;
+    }
+
+    const int range = 1;
+    auto& seen = w.seen;
+    seen.clear();
+    for (const auto& s : stones) {
+        for (int dx = -range; dx <= range; ++dx) {
+            for (int dy = -range; dy <= range; ++dy) {
+                int r = s.row + dx, c = s.col + dy;
+                if (board.cellCode(r, c) == 0) seen.push_back(SparseBoard::key(r, c));
+            }
+        }
+    }
+    std::sort(seen.begin(), seen.end());
+    seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+    for (uint64_t k : seen) {
+        int r = static_cast<int32_t>(k >> 32), c = static_cast<int32_t>(k & 0xFFFFFFFFu);
+        if (!Rule::hasForbidden || !Rule::isForbidden(board, r, c, mover)) moves.emplace_back(r, c);
+    }
+}
+
+template <class Rule>
+bool SparseSearchEngine<Rule>::outOfTime() {
+    if (timeUp.load(std::memory_order_relaxed)) return true;
+    if (std::chrono::steady_clock::now() > deadline || (stopFlag && stopFlag->load(std::memory_order_relaxed))) {
+        timeUp.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+template <class Rule>
+bool SparseSearchEngine<Rule>::packMove(const SparseBoard& board, std::pair<int, int> move, int& row, int& col) {
+    row = move.first - board.minRow() + 1;
+    col = move.second - board.minCol() + 1;
+    return row >= 0 && row <= 127 && col >= 0 && col <= 127;
+}
+
+template <class Rule>
+int SparseSearchEngine<Rule>::minimax(SparseBoard& board, int depth, int ply, bool maximizing, int alpha, int beta,
+                                      uint64_t hash, Worker& w) {
+    nodes.fetch_add(1, std::memory_order_relaxed);
+    if (outOfTime()) {
+        return evaluate(board, w);  // 超過時間限制，直接返回評分
+    }
+
+    const int alphaOrig = alpha, betaOrig = beta;
+    TranspositionTable::Entry entry;
+    if (transpositionTable.probe(hash, entry) && entry.depth >= depth) {
+        if (entry.bound == TranspositionTable::EXACT) return entry.score;
+        if (entry.bound == TranspositionTable::LOWER && entry.score >= beta) return entry.score;
+        if (entry.bound == TranspositionTable::UPPER && entry.score <= alpha) return entry.score;
+    }
+
+    if (depth == 0 || board.isFull()) {
+        int eval = evaluate(board, w);
+        transpositionTable.store(hash, eval, 0, TranspositionTable::EXACT);
+        return eval;
+    }
+
+    const char mover = maximizing ? symbol : opponentSymbol;
+    auto& moves = w.plyMoves[ply]; // scoreRootMoves() 已依深度配置好
+    generate(board, moves, mover, w);
+
+    int bestVal = maximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+    std::pair<int, int> bestMove = {0, 0};
+    bool hasBest = false;
+
+    for (size_t i = 0; i < moves.size(); ++i) {
+        auto [r, c] = moves[i];
+        board.placePiece(r, c, mover);
+
+        int score;
+        if (Rule::isWin(board, r, c, mover)) {
+            score = maximizing ? 100000 : -100000;
+        } else {
+            score = minimax(board, depth - 1, ply + 1, !maximizing, alpha, beta, hash ^ zobristKey(r, c, mover), w);
+        }
+        board.removePiece(r, c);
+
+        if (maximizing ? score > bestVal : score < bestVal) {
+            bestVal = score;
+            bestMove = {r, c};
+            hasBest = true;
+        }
+        if (maximizing) {
+            alpha = std::max(alpha, bestVal);
+        } else {
+            beta = std::min(beta, bestVal);
+        }
+        if (beta <= alpha) break;
+    }
+
+    if (timeUp.load(std::memory_order_relaxed)) return bestVal;
+
+    TranspositionTable::Bound bound = TranspositionTable::EXACT;
+    if (bestVal <= alphaOrig) bound = TranspositionTable::UPPER;
+    else if (bestVal >= betaOrig) bound = TranspositionTable::LOWER;
+    int row = -1, col = -1;
+    if (!hasBest || !packMove(board, bestMove, row, col)) row = col = -1;
+    transpositionTable.store(hash, bestVal, depth, bound, row, col);
+    return bestVal;
+}
+
+// 根節點平行化：各執行緒持有自己的棋盤副本與暫存，輪流領取下一個根節點走法，共用置換表
+template <class Rule>
+void SparseSearchEngine<Rule>::scoreRootMoves(const SparseBoard& board, const std::vector<std::pair<int, int>>& moves,
+                                              int* scores) {
+    int workerCount = std::min<int>(threadLimit, std::max(1u, std::thread::hardware_concurrency()));
+    workerCount = std::max(1, std::min<int>(workerCount, static_cast<int>(moves.size())));
+
+    const uint64_t rootHash = computeZobristHash(board);
+    std::atomic<int> nextIndex{0};
+    auto run = [&](Worker& w) {
+        if (static_cast<int>(w.plyMoves.size()) < depth) w.plyMoves.resize(depth);
+        SparseBoard copy = board;
+        for (int i = nextIndex++; i < static_cast<int>(moves.size()); i = nextIndex++) {
+            auto [r, c] = moves[i];
+            copy.placePiece(r, c, symbol);
+            scores[i] = minimax(copy, depth, 0, false, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(),
+                                rootHash ^ zobristKey(r, c, symbol), w);
+            copy.removePiece(r, c);
+        }
+    };
+
+    std::vector<Worker> helpers(workerCount - 1);
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount - 1);
+    for (int t = 1; t < workerCount; ++t) threads.emplace_back([&, t]() { run(helpers[t - 1]); });
+    run(main);
+    for (auto& t : threads) t.join();
+}
+
+// 從根節點的最佳步開始，沿著置換表記錄的最佳步走出主要變化
+template <class Rule>
+void SparseSearchEngine<Rule>::extractPV(SparseBoard board, SearchResult& result) {
+    result.pv.clear();
+    char mover = symbol;
+    std::pair<int, int> move = result.move;
+    uint64_t hash = computeZobristHash(board);
+    for (int ply = 0; ply <= depth; ++ply) {
+        if (!board.placePiece(move.first, move.second, mover)) break;
+        result.pv.push_back(move);
+        if (Rule::isWin(board, move.first, move.second, mover)) break;
+        hash ^= zobristKey(move.first, move.second, mover);
+        mover = (mover == 'X') ? 'O' : 'X';
+
+        TranspositionTable::Entry entry;
+        if (!transpositionTable.probe(hash, entry) || entry.row < 0) break;
+        move = {entry.row + board.minRow() - 1, entry.col + board.minCol() - 1};
+    }
+}
+
+// 沒有候選步時（連珠黑棋在棋子周圍全是禁手、或有界棋盤已滿）找任一合法空點：
+// 有界棋盤整盤找離外框中心最近的一點；無邊界棋盤沿外框往外一圈圈找，離所有棋子 6 格以上
+// 的空點不會成任何棋型，最晚第 6 圈一定找得到
+template <class Rule>
+bool SparseSearchEngine<Rule>::fallbackMove(const SparseBoard& board, std::pair<int, int>& move) const {
+    const int midRow = board.minRow() + (board.maxRow() - board.minRow()) / 2;
+    const int midCol = board.minCol() + (board.maxCol() - board.minCol()) / 2;
+    auto legal = [&](int r, int c) {
+        return board.cellCode(r, c) == 0 && !Rule::isForbidden(board, r, c, symbol);
+    };
+
+    if (board.getLimit() > 0) {
+        long long bestDistance = -1;
+        for (int r = 0; r < board.getLimit(); ++r) {
+            for (int c = 0; c < board.getLimit(); ++c) {
+                if (!legal(r, c)) continue;
+                long long distance = std::max(std::abs(static_cast<long long>(r) - midRow),
+                                              std::abs(static_cast<long long>(c) - midCol));
+                if (bestDistance < 0 || distance < bestDistance) {
+                    bestDistance = distance;
+                    move = {r, c};
+                }
+            }
+        }
+        return bestDistance >= 0;
+    }
+
+    for (int d = 2; d <= 6; ++d) {
+        const int top = board.minRow() - d, bottom = board.maxRow() + d;
+        const int left = board.minCol() - d, right = board.maxCol() + d;
+        for (int r = top; r <= bottom; ++r) {
+            const bool edge = r == top || r == bottom;
+            for (int c = left; c <= right; c = (edge || c == right) ? c + 1 : right) {
+                if (legal(r, c)) {
+                    move = {r, c};
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+template <class Rule>
+SearchResult SparseSearchEngine<Rule>::analyze(SparseBoard& board) {
+    const auto start = std::chrono::steady_clock::now();
+    deadline = start + maxTime;
+    timeUp = false;
+    nodes = 0;
+    transpositionTable.clear(); // 每次重新開始
+
+    SearchResult result;
+    auto finish = [&]() {
+        if (result.pv.empty()) result.pv.push_back(result.move);
+        result.nodes = nodes.load();
+        result.elapsedMs =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    };
+
+    std::vector<std::pair<int, int>> moves;
+    generate(board, moves, symbol, main);
+    if (board.stoneCount() == 0) {
+        result.move = moves[0]; // 空棋盤下中心
+        return finish();
+    }
+    if (moves.empty()) {
+        if (!fallbackMove(board, result.move)) {
+            result.move = {-1, -1};
+            result.source = "none";
+            result.nodes = nodes.load();
+            return result;
+        }
+        return finish();
+    }
+
+    // 1. 能直接獲勝就下；2. 對手下一步能連五就擋（擋點對自己是禁手時擋不了）
+    std::vector<std::pair<int, int>> threats;
+    for (char who : {symbol, opponentSymbol}) {
+        generate(board, threats, who, main);
+        for (auto [r, c] : threats) {
+            board.placePiece(r, c, who);
+            bool win = Rule::isWin(board, r, c, who);
+            board.removePiece(r, c);
+            if (!win || (who != symbol && Rule::isForbidden(board, r, c, symbol))) continue;
+            result.move = {r, c};
+            if (who == symbol) {
+                result.score = 100000;
+                result.source = "win";
+            } else {
+                board.placePiece(r, c, symbol);
+                result.score = evaluate(board, main);
+                board.removePiece(r, c);
+                result.source = "block";
+            }
+            return finish();
+        }
+    }
+
+    // 3. minimax 找最好的位置
+    std::vector<int> scores(moves.size());
+    scoreRootMoves(board, moves, scores.data());
+    result.score = std::numeric_limits<int>::min();
+    result.move = moves[0];
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (scores[i] > result.score) {
+            result.score = scores[i];
+            result.move = moves[i];
+        }
+    }
+    extractPV(board, result);
+    return finish();
+}
+
+template class SparseSearchEngine<FreestyleRule>;
+template class SparseSearchEngine<StandardRule>;
+template class SparseSearchEngine<RenjuRule>;
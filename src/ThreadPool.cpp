@@ -0,0 +1,54 @@
+#include "ThreadPool.hpp"
+#include "LargePages.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads, bool pin) {
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(threads);
+    for (int i = 0; i < threads; ++i) workers.emplace_back(&ThreadPool::workerLoop, this, i, pin);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    ready.notify_one();
+}
+
+size_t ThreadPool::pending() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+int ThreadPool::busy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return running;
+}
+
+void ThreadPool::workerLoop(int index, bool pin) {
+    if (pin) pinCurrentThread(index);
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [&] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return; // stopping 且工作已清空
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            ++running;
+        }
+        task();
+        std::lock_guard<std::mutex> lock(mutex);
+        --running;
+    }
+}
@@ -0,0 +1,139 @@
+#include "TranspositionTable.hpp"
+#include <cstring>
+#include <iostream>
+#include <new>
+
+static const char TT_MAGIC[8] = {'G', 'M', 'K', 'T', 'T', '\0', '\0', '\0'};
+
+TranspositionTable::TranspositionTable(size_t sizeMB) {
+    resize(sizeMB);
+}
+
+void TranspositionTable::resize(size_t sizeMB) {
+    if (file.isOpen()) {
+        file.flush();
+        file.close();
+    }
+
+    // 取不超過指定大小的 2 的冪次，索引只需要做 AND
+    size_t wanted = (sizeMB * 1024 * 1024) / sizeof(Slot);
+    slotCount = 1;
+    while (slotCount * 2 <= wanted) slotCount *= 2;
+    mask = slotCount - 1;
+    heap.release(); // 先釋放舊表，避免新舊同時佔用記憶體
+    allocateHeap();
+}
+
+void TranspositionTable::allocateHeap() {
+    if (!heap.allocate(slotCount * sizeof(Slot))) throw std::bad_alloc();
+    slots = static_cast<Slot*>(heap.data());
+}
+
+std::string TranspositionTable::memoryInfo() const {
+    return file.isOpen() ? "file" : heap.describe();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < slotCount; ++i) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t TranspositionTable::pack(int score, int depth, Bound bound, int row, int col) {
+    // [0,32) score | [32,40) depth | [40,48) bound+1 | [48,56) row | [56,64) col
+    // bound 存 +1，讓全 0 的槽位代表「空」
+    return static_cast<uint64_t>(static_cast<uint32_t>(score)) |
+           (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 32) |
+           (static_cast<uint64_t>(bound + 1) << 40) |
+           (static_cast<uint64_t>(static_cast<uint8_t>(row)) << 48) |
+           (static_cast<uint64_t>(static_cast<uint8_t>(col)) << 56);
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(uint64_t data) {
+    Entry e;
+    e.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    e.depth = static_cast<int8_t>((data >> 32) & 0xFF);
+    e.bound = static_cast<Bound>(((data >> 40) & 0xFF) - 1);
+    e.row = static_cast<int8_t>((data >> 48) & 0xFF);
+    e.col = static_cast<int8_t>((data >> 56) & 0xFF);
+    return e;
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& out) const {
+    const Slot& slot = slots[key & mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if (data == 0 || (check ^ data) != key) return false; // 空槽、碰撞或寫到一半
+    out = unpack(data);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, int score, int depth, Bound bound, int row, int col) {
+    Slot& slot = slots[key & mask];
+
+    // 同一局面已有更深的結果就保留（跨步、跨工作階段沿用時特別重要）
+    uint64_t old = slot.data.load(std::memory_order_relaxed);
+    if (old != 0 && (slot.check.load(std::memory_order_relaxed) ^ old) == key && unpack(old).depth > depth) return;
+
+    uint64_t data = pack(score, depth, bound, row, col);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::attach(const std::string& path, uint64_t signature) {
+    detach();
+
+    // 先只看標頭判斷能否沿用；已存在但不能沿用的檔案不動它，由呼叫端決定換檔名或刪除
+    MappedFile existing;
+    if (existing.openRead(path)) {
+        FileHeader header{};
+        bool isTable = existing.size() >= sizeof(FileHeader);
+        if (isTable) std::memcpy(&header, existing.data(), sizeof(header));
+        isTable = isTable && std::memcmp(header.magic, TT_MAGIC, sizeof(TT_MAGIC)) == 0 && header.version == FILE_VERSION &&
+                  header.slotCount != 0 && (header.slotCount & (header.slotCount - 1)) == 0 &&
+                  existing.size() == sizeof(FileHeader) + header.slotCount * sizeof(Slot);
+        existing.close();
+        if (!isTable) {
+            std::cerr << path << ": not a transposition table file\n";
+            return false;
+        }
+        if (header.signature != signature) {
+            std::cerr << path << ": saved for a different side, rule, evaluation or pruning setup\n";
+            return false;
+        }
+        if (!file.openReadWrite(path, sizeof(FileHeader) + header.slotCount * sizeof(Slot))) return false;
+        slotCount = header.slotCount;
+        mask = slotCount - 1;
+        if (largePagePolicy().pages != LargePagePolicy::Pages::Normal) file.adviseHugePages();
+        slots = reinterpret_cast<Slot*>(file.data() + sizeof(FileHeader));
+        heap.release();
+        return true;
+    }
+
+    // 不存在：以目前大小建立新檔（新檔內容全為 0，即空表）
+    if (!file.openReadWrite(path, sizeof(FileHeader) + slotCount * sizeof(Slot))) return false;
+
+    FileHeader header{};
+    std::memcpy(header.magic, TT_MAGIC, sizeof(TT_MAGIC));
+    header.version = FILE_VERSION;
+    header.slotCount = slotCount;
+    header.signature = signature;
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    if (largePagePolicy().pages != LargePagePolicy::Pages::Normal) file.adviseHugePages();
+    slots = reinterpret_cast<Slot*>(file.data() + sizeof(FileHeader));
+    heap.release();
+    return true;
+}
+
+void TranspositionTable::flush() {
+    if (file.isOpen()) file.flush();
+}
+
+void TranspositionTable::detach() {
+    if (!file.isOpen()) return;
+    file.flush();
+    file.close();
+    allocateHeap();
+}
@@ -0,0 +1,169 @@
+// 搜尋配置量測
+//
+//   alloc_bench [positions.txt] [--depth 6] [--threads 1] [--time 60000]
+//
+// 以計數版的全域 operator new 包住每次 analyze，檢查搜尋迴圈沒有配置記憶體。
+// 每個局面先以 depth 1 搜尋一次，得到與節點數無關的固定開銷（根節點的執行緒、主要變化等），
+// 再以 --depth 搜尋；多展開的節點若多出任何配置就算失敗，結束碼為 1。
+// 局面檔每行一個局面（座標記法，# 開頭為註解），不給就用內建的幾個開局
+#include "GameRecord.hpp"
+#include "SearchEngine.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+static std::atomic<uint64_t> allocations{0};
+
+// 配置與釋放各走一個不內聯的函式：編譯器看不到 operator new 裡的 malloc，
+// 就不會把 operator delete 裡的 free 當成配對錯誤（-Wmismatched-new-delete）
+__attribute__((noinline)) static void* acquire(size_t size, size_t align) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (align <= alignof(std::max_align_t)) return std::malloc(size ? size : 1);
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+__attribute__((noinline)) static void release(void* p) {
+    std::free(p);
+}
+
+void* operator new(size_t size) {
+    if (void* p = acquire(size, 0)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return acquire(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return acquire(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    if (void* p = acquire(size, static_cast<size_t>(align))) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { release(p); }
+
+static const char* DEFAULT_POSITIONS[] = {
+    "h8",
+    "h8 i9 j10",
+    "h8 h9 i8 g9",
+    "h8 i8 j8 i9 i10 h10",
+    "h8 i9 g9 i7 i8 g7 j10",
+};
+
+static void usage() {
+    std::cerr << "usage: alloc_bench [positions.txt] [--depth <n>] [--threads <n>] [--time <ms>]\n";
+}
+
+int main(int argc, char** argv) {
+    std::string input;
+    int depth = 6, threads = 1;
+    long long timeMs = 60000;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "--depth") depth = std::max(2, std::stoi(next()));
+            else if (arg == "--threads") threads = std::max(1, std::stoi(next()));
+            else if (arg == "--time") timeMs = std::stoll(next());
+            else if (!arg.empty() && arg[0] != '-' && input.empty()) input = arg;
+            else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 1;
+    }
+
+    std::vector<std::string> positions;
+    if (input.empty()) {
+        positions.assign(std::begin(DEFAULT_POSITIONS), std::end(DEFAULT_POSITIONS));
+    } else {
+        std::ifstream in(input);
+        if (!in) {
+            std::cerr << "Cannot open " << input << "\n";
+            return 1;
+        }
+        for (std::string line; std::getline(in, line);)
+            if (!line.empty() && line[0] != '#') positions.push_back(line);
+    }
+
+    bool ok = true;
+    uint64_t totalNodes = 0, totalExtra = 0;
+    for (const std::string& text : positions) {
+        std::vector<std::pair<int, int>> moves;
+        if (!parseMoveText(text, Board::SIZE, moves)) {
+            std::cerr << "Invalid position: " << text << "\n";
+            return 1;
+        }
+        Board board;
+        char turn = 'X';
+        for (auto [r, c] : moves) {
+            if (!board.placePiece(r, c, turn)) {
+                std::cerr << "Illegal position: " << text << "\n";
+                return 1;
+            }
+            turn = (turn == 'X') ? 'O' : 'X';
+        }
+
+        SearchEngine<Board::SIZE> engine(turn);
+        engine.setThreads(threads);
+        engine.setTimeLimit(std::chrono::milliseconds(timeMs));
+
+        // 固定開銷：同一個局面只搜一層（也順便讓第一次使用才配置的東西先配置好）
+        engine.setDepth(1);
+        engine.analyze(board);
+        uint64_t before = allocations.load();
+        SearchResult shallow = engine.analyze(board);
+        const uint64_t baseline = allocations.load() - before;
+
+        engine.setDepth(depth);
+        before = allocations.load();
+        SearchResult deep = engine.analyze(board);
+        const uint64_t used = allocations.load() - before;
+
+        // 主要變化隨深度變長，vector 擴充的次數允許多出 log2(長度) 次
+        uint64_t pvGrowth = 0;
+        for (size_t n = shallow.pv.size(); n < deep.pv.size(); n *= 2) ++pvGrowth, n = std::max<size_t>(n, 1);
+        const uint64_t extra = used > baseline ? used - baseline : 0;
+        const bool pass = extra <= pvGrowth;
+        ok = ok && pass;
+        totalNodes += deep.nodes;
+        totalExtra += extra;
+
+        std::printf("%-28s nodes=%-9llu allocs=%llu baseline=%llu extra=%llu %s\n", text.c_str(),
+                    static_cast<unsigned long long>(deep.nodes), static_cast<unsigned long long>(used),
+                    static_cast<unsigned long long>(baseline), static_cast<unsigned long long>(extra),
+                    pass ? "ok" : "FAIL");
+    }
+    std::printf("%llu nodes, %llu allocations beyond the fixed per-search cost\n",
+                static_cast<unsigned long long>(totalNodes), static_cast<unsigned long long>(totalExtra));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,332 @@
+// 批次局面分析工具
+//
+//   batch_analyze [positions.txt] [--records games.gmr] [--size 15] [--time 1000] [--depth 4]
+//                 [--workers N] [--hash 16] [--queue 256] [--nnue eval.nnue] [--width 0,16,12,10,8]
+//                 [--large-pages off|thp|explicit] [--numa local|interleave|firsttouch] [--pin]
+//                 [--trace search.trc] [--probcut probcut.params] [--tt-file analysis.tt]
+//
+// 每行一個局面（座標記法，例如 "h8 i9 j10"，# 開頭為註解），不給檔案就讀標準輸入；
+// --records 則把棋譜裡每一局的每一步都當成一個局面。輪到誰由手數奇偶決定。
+// --width 為每層保留的候選步數（0 不限，見 SearchEngine::setMoveWidths），"none" 表示不剪枝（引擎預設）。
+// 每個工作執行緒有自己的置換表；--pin 把工作執行緒平均綁到各 NUMA 節點，
+// 搭配 --numa local 時各自的表格就配置在自己的節點上（第一次寫入的位置）。
+// --trace 把每次搜尋展開的節點寫到追蹤檔（trace_tool 檢視），各局面以搜尋編號區分。
+// --tt-file 把置換表存到檔案，重跑時接續上次的分析（輸出的 tt_hits 會明顯變多）：
+// 每個工作執行緒的每一方各一個檔案（<path>.X0、<path>.O0 ...），局面分到哪個執行緒不固定，
+// 要每個局面都接得上就用相同的設定加上 --workers 1。
+// 輸出為 JSONL，一行一個局面，順序依完成先後，以 id 對應輸入
+#include "GameRecord.hpp"
+#include "SearchEngine.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Job {
+    std::string id;
+    std::vector<std::pair<int, int>> moves;
+};
+
+// 有上限的工作佇列：讀取端太快時會被擋住，記憶體用量不隨輸入大小成長
+class JobQueue {
+public:
+    explicit JobQueue(size_t capacity) : capacity(capacity) {}
+
+    void push(Job job) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return jobs.size() < capacity; });
+        jobs.push_back(std::move(job));
+        notEmpty.notify_one();
+    }
+
+    bool pop(Job& job) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&] { return !jobs.empty() || closed; });
+        if (jobs.empty()) return false;
+        job = std::move(jobs.front());
+        jobs.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+private:
+    size_t capacity;
+    std::deque<Job> jobs;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable notEmpty, notFull;
+};
+
+struct Options {
+    int timeMs = 1000;
+    int depth = 4;
+    size_t hashMB = 16;
+    const NnueNetwork* network = nullptr; // 不為 nullptr 時改用網路評估
+    std::optional<std::vector<int>> widths; // 沒給就用引擎預設（不剪枝）
+    bool pin = false;
+    SearchTrace* trace = nullptr;
+    ProbCutParams probCut; // 預設不啟用
+    bool reportMemory = false; // 有指定記憶體選項時，在 stderr 回報實際的配置結果
+    std::string tableFile;     // 空字串表示置換表不存檔
+};
+
+// "0,16,12" → {0, 16, 12}；"none" → 空陣列
+static std::vector<int> parseWidths(const std::string& text) {
+    std::vector<int> widths;
+    if (text == "none") return widths;
+    std::istringstream in(text);
+    std::string field;
+    while (std::getline(in, field, ',')) widths.push_back(std::max(0, std::stoi(field)));
+    return widths;
+}
+
+static std::string moveText(int size, std::pair<int, int> move) {
+    if (move.first < 0) return "none";
+    GameRecord one;
+    one.boardSize = size;
+    one.moves.push_back(move);
+    return formatMoveText(one);
+}
+
+static std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        if (static_cast<unsigned char>(ch) < 0x20) continue;
+        out += ch;
+    }
+    return out + "\"";
+}
+
+static std::mutex outputMutex;
+
+template <int N>
+static void worker(JobQueue& queue, const Options& options, int index) {
+    if (options.pin) pinCurrentThread(index); // 先綁定再配置表格
+    // 每個工作執行緒各自擁有雙方的引擎，根節點只用單一執行緒，平行度交給工作執行緒數
+    SearchEngine<N> engines[2] = {SearchEngine<N>('X', options.hashMB), SearchEngine<N>('O', options.hashMB)};
+    for (auto& engine : engines) {
+        engine.setTimeLimit(std::chrono::milliseconds(options.timeMs));
+        engine.setDepth(options.depth);
+        engine.setThreads(1);
+        if (options.network) engine.setNetwork(options.network);
+        if (options.widths) engine.setMoveWidths(*options.widths);
+        engine.setTrace(options.trace);
+        engine.setProbCut(options.probCut);
+    }
+    // 存檔的指紋含權重、剪枝等設定，要在設定完才掛上
+    if (!options.tableFile.empty()) {
+        for (auto& engine : engines) {
+            std::string path = options.tableFile + "." + engine.getSymbol() + std::to_string(index);
+            if (!engine.attachTableFile(path)) {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cerr << path << ": not a table file for these settings, keeping the table in memory\n";
+            }
+        }
+    }
+    if (options.reportMemory && index == 0) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cerr << "memory: " << memoryTopologySummary() << "; worker tables " << engines[0].memoryInfo() << "\n";
+    }
+
+    Job job;
+    while (queue.pop(job)) {
+        std::ostringstream line;
+        line << "{\"id\":" << jsonString(job.id);
+
+        BasicBoard<N> board;
+        char turn = 'X';
+        bool legal = true;
+        for (auto [r, c] : job.moves) {
+            if (!board.placePiece(r, c, turn)) {
+                legal = false;
+                break;
+            }
+            turn = (turn == 'X') ? 'O' : 'X';
+        }
+
+        GameRecord position;
+        position.boardSize = N;
+        position.moves = job.moves;
+        line << ",\"position\":" << jsonString(formatMoveText(position));
+
+        if (!legal) {
+            line << ",\"error\":\"illegal move sequence\"}";
+        } else if (board.isFull()) {
+            line << ",\"error\":\"board full\"}";
+        } else {
+            auto result = engines[turn == 'X' ? 0 : 1].analyze(board);
+            line << ",\"side\":\"" << turn << "\""
+                 << ",\"move\":" << jsonString(moveText(N, result.move))
+                 << ",\"row\":" << result.move.first << ",\"col\":" << result.move.second
+                 << ",\"score\":" << result.score << ",\"pv\":[";
+            for (size_t i = 0; i < result.pv.size(); ++i)
+                line << (i ? "," : "") << jsonString(moveText(N, result.pv[i]));
+            double hitRate = result.evalProbes ? static_cast<double>(result.evalHits) / result.evalProbes : 0.0;
+            line << "],\"nodes\":" << result.nodes << ",\"eval_hit_rate\":" << hitRate << ",\"probcuts\":" << result.probCuts
+                 << ",\"tt_hits\":" << result.ttHits
+                 << ",\"time_ms\":" << result.elapsedMs
+                 << ",\"depth\":" << options.depth << ",\"source\":\"" << result.source << "\"}";
+        }
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << line.str() << "\n" << std::flush;
+    }
+    for (auto& engine : engines) engine.flushTableFile();
+}
+
+static void usage() {
+    std::cerr << "usage: batch_analyze [positions.txt] [--records <games.gmr>] [--size 15|19] [--time <ms>]\n"
+                 "                     [--depth <n>] [--workers <n>] [--hash <MB>] [--queue <n>] [--nnue <file>]\n"
+                 "                     [--width <n,n,...|none>] [--large-pages off|thp|explicit]\n"
+                 "                     [--numa local|interleave|firsttouch] [--pin] [--trace <file>]\n"
+                 "                     [--probcut <params>] [--tt-file <path>]\n";
+}
+
+// 讀取端：把輸入轉成工作丟進佇列，回傳是否成功
+static bool produce(JobQueue& queue, const std::string& input, const std::string& records, int size) {
+    if (!records.empty()) {
+        GameRecordReader reader;
+        if (!reader.open(records)) return false;
+        GameRecordReader::GameView view;
+        for (int g = 0; reader.next(view); ++g) {
+            if (view.boardSize() != size) {
+                std::cerr << "Skipping game " << g << ": board size " << view.boardSize() << "\n";
+                continue;
+            }
+            Job job;
+            for (int ply = 0; ply < view.moveCount(); ++ply) {
+                job.id = std::to_string(g) + ":" + std::to_string(ply);
+                queue.push(job);
+                job.moves.push_back(view.move(ply));
+            }
+        }
+        return true;
+    }
+
+    std::ifstream file;
+    if (!input.empty()) {
+        file.open(input);
+        if (!file) {
+            std::cerr << "Cannot open " << input << "\n";
+            return false;
+        }
+    }
+    std::istream& in = input.empty() ? std::cin : file;
+
+    std::string text;
+    for (int lineNo = 1; std::getline(in, text); ++lineNo) {
+        if (!text.empty() && text.back() == '\r') text.pop_back();
+        if (!text.empty() && text[0] == '#') continue;
+        Job job;
+        job.id = std::to_string(lineNo);
+        if (!parseMoveText(text, size, job.moves)) {
+            std::cerr << "Line " << lineNo << ": invalid moves\n";
+            continue;
+        }
+        queue.push(std::move(job));
+    }
+    return true;
+}
+
+template <int N>
+static int run(const std::string& input, const std::string& records, const Options& options, int workers, size_t queueSize) {
+    JobQueue queue(queueSize);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; ++i) threads.emplace_back(worker<N>, std::ref(queue), std::cref(options), i);
+
+    bool ok = produce(queue, input, records, N);
+    queue.close();
+    for (auto& t : threads) t.join();
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    std::string input, records, networkPath, tracePath, probCutPath;
+    SearchTrace trace;
+    Options options;
+    NnueNetwork network;
+    int size = 15;
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+    size_t queueSize = 256;
+    LargePagePolicy memory;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "--records") records = next();
+            else if (arg == "--size") size = std::stoi(next());
+            else if (arg == "--time") options.timeMs = std::stoi(next());
+            else if (arg == "--depth") options.depth = std::stoi(next());
+            else if (arg == "--workers") workers = std::max(1, std::stoi(next()));
+            else if (arg == "--hash") options.hashMB = std::stoul(next());
+            else if (arg == "--queue") queueSize = std::max<size_t>(1, std::stoul(next()));
+            else if (arg == "--nnue") networkPath = next();
+            else if (arg == "--width") options.widths = parseWidths(next());
+            else if (arg == "--large-pages" || arg == "--numa") {
+                bool ok = arg == "--numa" ? LargePagePolicy::parseNuma(next(), memory.numa)
+                                          : LargePagePolicy::parsePages(next(), memory.pages);
+                if (!ok) throw std::invalid_argument(arg);
+                options.reportMemory = true;
+            } else if (arg == "--pin") options.pin = options.reportMemory = true;
+            else if (arg == "--trace") tracePath = next();
+            else if (arg == "--probcut") probCutPath = next();
+            else if (arg == "--tt-file") options.tableFile = next();
+            else if (arg[0] != '-' && input.empty()) input = arg;
+            else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 1;
+    }
+
+    setLargePagePolicy(memory);
+
+    if (!networkPath.empty()) {
+        if (!network.load(networkPath)) return 1;
+        if (network.boardSize() != size) {
+            std::cerr << networkPath << ": network is for " << network.boardSize() << "x" << network.boardSize() << "\n";
+            return 1;
+        }
+        options.network = &network;
+    }
+
+    if (!probCutPath.empty() && !options.probCut.load(probCutPath)) {
+        std::cerr << "Cannot read " << probCutPath << "\n";
+        return 1;
+    }
+
+    if (!tracePath.empty()) {
+        if (!trace.open(tracePath, size)) {
+            std::cerr << "Cannot write " << tracePath << "\n";
+            return 1;
+        }
+        options.trace = &trace;
+    }
+
+    try {
+        return dispatchBoardSize(size, [&](auto n) {
+            return run<decltype(n)::value>(input, records, options, workers, queueSize);
+        });
+    } catch (const std::invalid_argument&) {
+        std::cerr << "Unsupported board size " << size << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,251 @@
+// 開局庫產生工具：從棋譜或自我對弈累積 (局面, 走法) 統計並寫成 mmap 用的開局庫
+//
+//   book_builder -o opening.book [--size 15] [--extend old.book]
+//                [--games games.txt] [--records games.gmr]
+//                [--selfplay N] [--plies 12] [--time 100] [--record selfplay.gmr]
+//
+// games.txt 每行一盤棋，走法寫成 "row,col"，以空白分隔；# 開頭為註解
+// --records 讀取二進位棋譜；--record 把自我對弈的棋局另存成棋譜
+#include "OpeningBook.hpp"
+#include "GameRecord.hpp"
+#include "SearchEngine.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Options {
+    std::string output;
+    std::string extend;
+    std::string games;
+    std::string records;
+    std::string record;
+    int size = 15;
+    int selfplay = 0;
+    int plies = 12;
+    int timeMs = 100;
+};
+
+static void usage() {
+    std::cerr << "usage: book_builder -o <book> [--size 15|19] [--extend <book>] [--games <file>]\n"
+                 "                    [--records <games.gmr>] [--selfplay <games>] [--plies <n>]\n"
+                 "                    [--time <ms>] [--record <games.gmr>]\n";
+}
+
+// 重播一盤棋，把前 plies 步的 (局面, 走法) 與最終結果加入紀錄
+// known 不為 Unknown 時以它為準（只重播前段棋步的情況）
+template <int N>
+static bool addGame(const std::vector<std::pair<int, int>>& moves, int plies, std::vector<OpeningBook::Record>& out,
+                    RecordResult known = RecordResult::Unknown) {
+    BasicBoard<N> board;
+    char turn = 'X';
+    char winner = '.';
+    std::vector<OpeningBook::Record> pending;
+
+    for (size_t i = 0; i < moves.size(); ++i) {
+        auto [r, c] = moves[i];
+        if (static_cast<int>(i) < plies) {
+            int sym;
+            uint64_t key = hashPosition(board).canonical(sym);
+            auto m = applySymmetry<N>(sym, r, c);
+            OpeningBook::Record rec{};
+            rec.hash = key;
+            rec.row = static_cast<uint8_t>(m.first);
+            rec.col = static_cast<uint8_t>(m.second);
+            rec.games = 1;
+            rec.wins = (turn == 'X') ? 1 : 2; // 暫存落子方，結果確定後再換算
+            pending.push_back(rec);
+        }
+        if (!board.placePiece(r, c, turn)) return false;
+        if (board.isWin(r, c, turn)) {
+            winner = turn;
+            break;
+        }
+        turn = (turn == 'X') ? 'O' : 'X';
+    }
+
+    if (known == RecordResult::BlackWin) winner = 'X';
+    else if (known == RecordResult::WhiteWin) winner = 'O';
+    else if (known == RecordResult::Draw) winner = '.';
+
+    for (auto& rec : pending) {
+        char mover = rec.wins == 1 ? 'X' : 'O';
+        rec.wins = (winner == mover) ? 1 : 0;
+        rec.draws = (winner == '.') ? 1 : 0;
+        out.push_back(rec);
+    }
+    return true;
+}
+
+template <int N>
+static std::vector<std::pair<int, int>> playSelfGame(std::mt19937& rng, int timeMs) {
+    SearchEngine<N> engines[2] = {SearchEngine<N>('X', 4), SearchEngine<N>('O', 4)};
+    for (auto& e : engines) e.setTimeLimit(std::chrono::milliseconds(timeMs));
+
+    BasicBoard<N> board;
+    std::vector<std::pair<int, int>> moves;
+    char turn = 'X';
+
+    // 第一步下天元，第二步在周圍隨機選一格，讓每盤棋走向不同
+    std::pair<int, int> first = {N / 2, N / 2};
+    std::uniform_int_distribution<int> offset(-1, 1);
+    std::pair<int, int> second;
+    do {
+        second = {N / 2 + offset(rng), N / 2 + offset(rng)};
+    } while (second == first);
+
+    while (!board.isFull()) {
+        std::pair<int, int> move;
+        if (moves.empty()) move = first;
+        else if (moves.size() == 1) move = second;
+        else move = engines[turn == 'X' ? 0 : 1].search(board);
+        if (move.first < 0) break; // 無步可下（連珠黑棋只剩禁手）
+
+        board.placePiece(move.first, move.second, turn);
+        moves.push_back(move);
+        if (board.isWin(move.first, move.second, turn)) break;
+        turn = (turn == 'X') ? 'O' : 'X';
+    }
+    return moves;
+}
+
+static bool parseGameLine(const std::string& line, std::vector<std::pair<int, int>>& moves) {
+    moves.clear();
+    std::istringstream in(line);
+    std::string token;
+    while (in >> token) {
+        int r, c;
+        char comma;
+        std::istringstream t(token);
+        if (!(t >> r >> comma >> c) || comma != ',') return false;
+        moves.emplace_back(r, c);
+    }
+    return true;
+}
+
+template <int N>
+static int build(const Options& opt) {
+    std::vector<OpeningBook::Record> records;
+
+    if (!opt.extend.empty()) {
+        OpeningBook old;
+        if (!old.open(opt.extend) || old.boardSize() != N) {
+            std::cerr << "Cannot open book to extend: " << opt.extend << "\n";
+            return 1;
+        }
+        records.assign(old.begin(), old.end());
+        std::cout << "Loaded " << records.size() << " records from " << opt.extend << "\n";
+    }
+
+    if (!opt.games.empty()) {
+        std::ifstream in(opt.games);
+        if (!in) {
+            std::cerr << "Cannot open game file: " << opt.games << "\n";
+            return 1;
+        }
+        std::string line;
+        std::vector<std::pair<int, int>> moves;
+        int count = 0, skipped = 0;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            if (parseGameLine(line, moves) && addGame<N>(moves, opt.plies, records)) count++;
+            else skipped++;
+        }
+        std::cout << "Imported " << count << " games (" << skipped << " skipped)\n";
+    }
+
+    if (!opt.records.empty()) {
+        GameRecordReader reader;
+        if (!reader.open(opt.records)) {
+            std::cerr << "Cannot open records: " << opt.records << "\n";
+            return 1;
+        }
+        GameRecordReader::GameView game;
+        std::vector<std::pair<int, int>> moves;
+        int count = 0;
+        while (reader.next(game)) {
+            if (game.boardSize() != N || game.result() == RecordResult::Unknown) continue;
+            moves.clear();
+            for (int i = 0; i < game.moveCount() && i < opt.plies + 1; ++i) moves.push_back(game.move(i));
+            // 只重播前段會看不到結果，改用紀錄裡的結果
+            if (!addGame<N>(moves, opt.plies, records, game.result())) continue;
+            count++;
+        }
+        std::cout << "Imported " << count << " recorded games\n";
+    }
+
+    GameRecordWriter recorder;
+    if (!opt.record.empty() && !recorder.open(opt.record)) {
+        std::cerr << "Cannot open " << opt.record << "\n";
+        return 1;
+    }
+
+    std::mt19937 rng(12345);
+    for (int g = 0; g < opt.selfplay; ++g) {
+        auto moves = playSelfGame<N>(rng, opt.timeMs);
+        if (recorder.isOpen()) {
+            GameRecord game;
+            game.boardSize = N;
+            game.black = game.white = "selfplay";
+            game.timePerMoveMs = static_cast<uint32_t>(opt.timeMs);
+            game.searchDepth = 4;
+            game.moves = moves;
+            BasicBoard<N> board;
+            char turn = 'X';
+            game.result = RecordResult::Draw;
+            for (auto [r, c] : moves) {
+                board.placePiece(r, c, turn);
+                if (board.isWin(r, c, turn)) game.result = (turn == 'X') ? RecordResult::BlackWin : RecordResult::WhiteWin;
+                turn = (turn == 'X') ? 'O' : 'X';
+            }
+            recorder.write(game);
+        }
+        addGame<N>(moves, opt.plies, records);
+        std::cout << "Self-play game " << (g + 1) << "/" << opt.selfplay << "\r" << std::flush;
+    }
+    if (opt.selfplay > 0) std::cout << "\n";
+
+    if (!OpeningBook::write(opt.output, N, std::move(records))) {
+        std::cerr << "Failed to write " << opt.output << "\n";
+        return 1;
+    }
+
+    OpeningBook book;
+    if (book.open(opt.output)) std::cout << "Wrote " << book.recordCount() << " records to " << opt.output << "\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "-o") opt.output = next();
+            else if (arg == "--size") opt.size = std::stoi(next());
+            else if (arg == "--extend") opt.extend = next();
+            else if (arg == "--games") opt.games = next();
+            else if (arg == "--records") opt.records = next();
+            else if (arg == "--record") opt.record = next();
+            else if (arg == "--selfplay") opt.selfplay = std::stoi(next());
+            else if (arg == "--plies") opt.plies = std::stoi(next());
+            else if (arg == "--time") opt.timeMs = std::stoi(next());
+            else {
+                usage();
+                return 1;
+            }
+        }
+        if (opt.output.empty()) {
+            usage();
+            return 1;
+        }
+
+        return dispatchBoardSize(opt.size, [&](auto n) { return build<decltype(n)::value>(opt); });
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,352 @@
+// 多對局引擎伺服器（標準輸入輸出多工）
+//
+//   engine_server [--threads N] [--hash 1024] [--max-sessions 64] [--slice 100]
+//                 [--large-pages off|thp|explicit] [--numa local|interleave|firsttouch] [--pin]
+//                 [--record <games.gmr>] [--tt-file <prefix>]
+//
+// 每行一個指令，以對局 id 區分：
+//   open <id> <15|19> <X|O>   建立對局，AI 執 X 或 O        -> ok open <id> hash=<MB> memory=<頁面/NUMA>
+//   move <id> <h8>            任一方落子                    -> ok move <id>
+//   go <id> [ms]              輪到 AI 時替它搜尋（非同步）   -> bestmove <id> <move> score=.. ...
+//   stop <id>                 提早結束進行中的搜尋
+//   close <id>                                             -> ok close <id>
+//   stats                                                  -> stats sessions=.. queued=.. busy=..
+//   quit
+// 錯誤一律回覆 "error <id> <訊息>"。
+//
+// 所有對局的搜尋都排進同一個執行緒池（每次搜尋單執行緒），總執行緒數固定，
+// 負載再高也不會超額訂閱核心。排程以對局為單位輪流：一次 go 切成 --slice 毫秒的時間片，
+// 每跑完一片就排回佇列尾端，讓其他在等的對局先跑，長考的對局不會霸佔執行緒。
+// 置換表在時間片之間保留，下一片的反覆加深很快就追回上一片的深度。
+// go 的 ms 是這步實際分到的搜尋時間；機器滿載時回覆會變慢（wait= 為排隊的時間），但每局分到的搜尋量相同。
+// 記憶體政策：置換表總量 --hash 固定，每局在 open 時分到 hash / max-sessions（至少 1 MB），
+// 與目前開了幾局無關，所以總用量永遠不超過 --hash；空著的名額不會分給其他對局，
+// 對局少而想要大表時就調低 --max-sessions。
+// --pin 把池中的執行緒平均綁到各 NUMA 節點；表格預設用透明大頁並分散到各節點。
+// --record 把每局的棋譜寫進檔案。同時有多局在下，不能逐步追加，每局在分出勝負、下滿、
+// close 或 quit 時才整盤寫入（沒下完的結果記為 Unknown）；落子只在讀取端處理，寫入不必上鎖。
+// --tt-file 讓每局的置換表存到 <prefix>.<id>.<大小><執子>，之後以同樣的 id 開局就接續先前的分析；
+// 檔案的大小是建立時的每局分配量，close 或 quit 時寫回。
+#include "GameRecord.hpp"
+#include "SearchEngine.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+static std::mutex outputMutex;
+
+static void reply(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
+}
+
+// 對局 id 由客戶端決定，放進檔名前把路徑分隔等字元換掉
+static std::string fileSafe(const std::string& text) {
+    std::string out = text;
+    for (auto& ch : out)
+        if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '-' && ch != '_') ch = '_';
+    return out;
+}
+
+// 單一對局；棋盤只在沒有搜尋進行時由讀取端修改
+class Session {
+public:
+    virtual ~Session() {}
+    virtual bool move(const std::string& text, std::string& error) = 0;
+    virtual bool aiToMove() const = 0;
+    // 在池中的執行緒上跑一個時間片；這步的搜尋結束時回傳 true，回覆放在 reply
+    virtual bool searchSlice(long long sliceMs, std::string& reply) = 0;
+    virtual std::string memoryInfo() const = 0;
+    virtual bool attachTableFile(const std::string& prefix) = 0;
+
+    const std::string id;
+    GameRecord record;    // 目前為止的走法，result 在分出勝負或下滿時填上
+    bool finished = false;
+    bool saved = false;   // 已寫進 --record 的檔案
+    std::atomic<bool> busy{false};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> closed{false};
+
+    // 進行中的 go，busy 期間只由正在跑時間片的執行緒存取
+    Clock::time_point submitted;
+    long long budgetMs = 0;
+    long long searchedMs = 0;
+
+protected:
+    explicit Session(const std::string& id) : id(id) {}
+};
+
+template <int N>
+class SessionImpl : public Session {
+public:
+    SessionImpl(const std::string& id, char aiSymbol, size_t hashMB)
+        : Session(id), aiSymbol(aiSymbol), engine(aiSymbol, hashMB) {
+        record.boardSize = N;
+        record.rule = ActiveRule::id;
+        record.black = aiSymbol == 'X' ? "engine_server" : id;
+        record.white = aiSymbol == 'X' ? id : "engine_server";
+        engine.setThreads(1); // 平行度由執行緒池負責
+        engine.setKeepTable(true);
+        engine.setStopFlag(&stop);
+    }
+
+    bool move(const std::string& text, std::string& error) override {
+        std::vector<std::pair<int, int>> moves;
+        if (!parseMoveText(text, N, moves) || moves.size() != 1) {
+            error = "invalid move " + text;
+            return false;
+        }
+        auto [r, c] = moves[0];
+        if (!board.placePiece(r, c, turn)) {
+            error = "occupied " + text;
+            return false;
+        }
+        record.moves.emplace_back(r, c);
+        if (!finished && ActiveRule::isWin(board, r, c, turn)) {
+            record.result = turn == 'X' ? RecordResult::BlackWin : RecordResult::WhiteWin;
+            finished = true;
+        } else if (!finished && board.isFull()) {
+            record.result = RecordResult::Draw;
+            finished = true;
+        }
+        turn = (turn == 'X') ? 'O' : 'X';
+        return true;
+    }
+
+    bool aiToMove() const override { return turn == aiSymbol; }
+
+    bool searchSlice(long long sliceMs, std::string& reply) override {
+        std::ostringstream out;
+        if (board.isFull()) {
+            out << "error " << id << " board full";
+            reply = out.str();
+            return true;
+        }
+        const long long limit = std::max(1LL, std::min(sliceMs, budgetMs - searchedMs));
+        engine.setTimeLimit(std::chrono::milliseconds(limit));
+        auto start = Clock::now();
+        SearchResult result = engine.analyze(board);
+        searchedMs += std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+        // 時間片用完前就搜到設定的深度，或是開局庫 / 必勝 / 必擋，就不必再排隊
+        bool done = stop || searchedMs >= budgetMs || result.elapsedMs < limit || std::string(result.source) != "search";
+        if (!done) return false;
+
+        if (result.move.first < 0) { // 連珠黑棋只剩禁手
+            out << "error " << id << " no legal move";
+            reply = out.str();
+            return true;
+        }
+        auto wall = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - submitted).count();
+        GameRecord one;
+        one.boardSize = N;
+        one.moves.push_back(result.move);
+        out << "bestmove " << id << " " << formatMoveText(one) << " score=" << result.score
+            << " nodes=" << result.nodes << " evalhits=" << result.evalHits << "/" << result.evalProbes
+            << " tthits=" << result.ttHits
+            << " time=" << searchedMs << " wait=" << std::max(0LL, static_cast<long long>(wall) - searchedMs)
+            << " source=" << result.source;
+        reply = out.str();
+        return true;
+    }
+
+    std::string memoryInfo() const override { return engine.memoryInfo(); }
+
+    bool attachTableFile(const std::string& prefix) override {
+        return engine.attachTableFile(prefix + "." + fileSafe(id) + "." + std::to_string(N) + aiSymbol);
+    }
+
+    ~SessionImpl() override { engine.flushTableFile(); }
+
+private:
+    BasicBoard<N> board;
+    char turn = 'X';
+    char aiSymbol;
+    SearchEngine<N> engine;
+};
+
+static std::shared_ptr<Session> makeSession(const std::string& id, int size, char aiSymbol, size_t hashMB) {
+    try {
+        return dispatchBoardSize(size, [&](auto n) -> std::shared_ptr<Session> {
+            return std::make_shared<SessionImpl<decltype(n)::value>>(id, aiSymbol, hashMB);
+        });
+    } catch (const std::invalid_argument&) {
+        return nullptr;
+    }
+}
+
+// 跑一個時間片；還沒搜完就重新提交，排在其他對局已經在等的時間片之後
+static void schedule(ThreadPool& pool, std::shared_ptr<Session> session, long long sliceMs) {
+    pool.submit([&pool, session, sliceMs]() {
+        std::string result;
+        if (!session->searchSlice(sliceMs, result)) {
+            schedule(pool, session, sliceMs);
+            return;
+        }
+        if (!session->closed) reply(result);
+        session->busy = false;
+    });
+}
+
+// 每局只寫一次；一步都沒下的不寫
+static void saveRecord(GameRecordWriter& writer, Session& session) {
+    if (!writer.isOpen() || session.saved || session.record.moves.empty()) return;
+    if (!writer.write(session.record)) std::cerr << "Failed to write record of " << session.id << "\n";
+    session.saved = true;
+}
+
+static void usage() {
+    std::cerr << "usage: engine_server [--threads <n>] [--hash <total MB>] [--max-sessions <n>] [--slice <ms>]\n"
+                 "                     [--large-pages off|thp|explicit] [--numa local|interleave|firsttouch] [--pin]\n"
+                 "                     [--record <games.gmr>] [--tt-file <prefix>]\n";
+}
+
+int main(int argc, char** argv) {
+    int threads = 0;
+    size_t hashMB = 1024;
+    size_t maxSessions = 64;
+    long long sliceMs = 100;
+    LargePagePolicy memory;
+    bool pin = false;
+    GameRecordWriter recorder;
+    std::string tablePrefix;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "--threads") threads = std::stoi(next());
+            else if (arg == "--hash") hashMB = std::stoul(next());
+            else if (arg == "--max-sessions") maxSessions = std::max<size_t>(1, std::stoul(next()));
+            else if (arg == "--slice") sliceMs = std::max(1LL, std::stoll(next()));
+            else if (arg == "--large-pages") {
+                if (!LargePagePolicy::parsePages(next(), memory.pages)) throw std::invalid_argument(arg);
+            } else if (arg == "--numa") {
+                if (!LargePagePolicy::parseNuma(next(), memory.numa)) throw std::invalid_argument(arg);
+            } else if (arg == "--pin") pin = true;
+            else if (arg == "--tt-file") tablePrefix = next();
+            else if (arg == "--record") {
+                std::string path = next();
+                if (!recorder.open(path)) {
+                    std::cerr << "Failed to open record file " << path << "\n";
+                    return 1;
+                }
+            }
+            else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 1;
+    }
+
+    const size_t sessionHashMB = std::max<size_t>(1, hashMB / maxSessions); // 見檔頭的記憶體政策
+    std::map<std::string, std::shared_ptr<Session>> sessions;
+    setLargePagePolicy(memory);
+    ThreadPool pool(threads, pin);
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream in(line);
+        std::string command, id;
+        in >> command >> id;
+        if (command.empty()) continue;
+
+        if (command == "quit") {
+            for (auto& entry : sessions) {
+                entry.second->stop = true; // 進行中的搜尋在這一片結束
+                saveRecord(recorder, *entry.second);
+            }
+            break;
+        }
+        if (command == "stats") {
+            reply("stats sessions=" + std::to_string(sessions.size()) + " queued=" + std::to_string(pool.pending()) +
+                  " busy=" + std::to_string(pool.busy()) + " threads=" + std::to_string(pool.size()) +
+                  " hash_per_session=" + std::to_string(sessionHashMB) + " numa_nodes=" + std::to_string(numaNodeCount()));
+            continue;
+        }
+        if (id.empty()) {
+            reply("error - missing session id");
+            continue;
+        }
+
+        auto it = sessions.find(id);
+        if (command == "open") {
+            int size = 0;
+            std::string side;
+            in >> size >> side;
+            if (it != sessions.end()) reply("error " + id + " already open");
+            else if (sessions.size() >= maxSessions) reply("error " + id + " server full");
+            else if (side != "X" && side != "O") reply("error " + id + " side must be X or O");
+            else if (auto session = makeSession(id, size, side[0], sessionHashMB)) {
+                if (!tablePrefix.empty() && !session->attachTableFile(tablePrefix)) {
+                    std::cerr << id << ": table file does not match this session, keeping the table in memory\n";
+                }
+                reply("ok open " + id + " hash=" + std::to_string(sessionHashMB) + " memory=" + session->memoryInfo());
+                sessions.emplace(id, std::move(session));
+            } else {
+                reply("error " + id + " unsupported board size");
+            }
+            continue;
+        }
+        if (it == sessions.end()) {
+            reply("error " + id + " no such session");
+            continue;
+        }
+        std::shared_ptr<Session> session = it->second;
+
+        if (command == "move") {
+            std::string text, error;
+            in >> text;
+            if (session->busy) reply("error " + id + " busy");
+            else if (!session->move(text, error)) reply("error " + id + " " + error);
+            else {
+                if (session->finished) saveRecord(recorder, *session);
+                reply("ok move " + id);
+            }
+        } else if (command == "go") {
+            long long ms = 1000;
+            in >> ms;
+            if (session->busy.exchange(true)) {
+                reply("error " + id + " busy");
+                continue;
+            }
+            if (!session->aiToMove()) {
+                session->busy = false;
+                reply("error " + id + " not engine's turn");
+                continue;
+            }
+            session->stop = false;
+            session->submitted = Clock::now();
+            session->budgetMs = std::max(1LL, ms);
+            session->record.timePerMoveMs = static_cast<uint32_t>(session->budgetMs);
+            session->searchedMs = 0;
+            schedule(pool, session, sliceMs);
+        } else if (command == "stop") {
+            session->stop = true;
+        } else if (command == "close") {
+            // 進行中的搜尋持有 shared_ptr，結束後才真正釋放
+            session->closed = true;
+            session->stop = true;
+            saveRecord(recorder, *session);
+            sessions.erase(it);
+            reply("ok close " + id);
+        } else {
+            reply("error " + id + " unknown command " + command);
+        }
+    }
+    return 0; // ThreadPool 解構時會等待剩下的搜尋
+}
@@ -0,0 +1,276 @@
+// 評估權重調整工具（Texel 法）
+//
+//   eval_tuner <games.gmr>... -o eval.params [--init eval.params] [--iters 300] [--threads N]
+//              [--skip 6] [--every 1] [--max-positions N]
+//
+// 從棋譜取樣局面，以對局結果（黑勝 1、和 0.5、白勝 0）為目標，
+// 最小化 sigmoid(K * 評估) 與結果的均方誤差。評估對 15 個權重是線性的，
+// 每個局面只需算一次特徵（各棋型的 X 窗口數減 O 窗口數），之後每輪只做內積，
+// 以所有核心分段平行計算損失與梯度。
+#include "Board.hpp"
+#include "GameRecord.hpp"
+#include "PatternTable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 每個局面 16 個 float（15 個特徵補齊），內層迴圈長度固定，編譯器可直接向量化
+static const int STRIDE = 16;
+
+struct Dataset {
+    std::vector<float> features; // size() * STRIDE
+    std::vector<float> targets;
+    size_t size() const { return targets.size(); }
+};
+
+struct SampleOptions {
+    int skip = 6;  // 開局前幾手不取
+    int every = 1; // 每隔幾手取一次
+    size_t maxPositions = 0;
+};
+
+// 與 PatternTable 同一套索引，查出每個窗口屬於哪個權重
+struct SlotTable {
+    int slot[PatternTable::COUNT];
+    int side[PatternTable::COUNT];
+    SlotTable() {
+        for (int idx = 0; idx < PatternTable::COUNT; ++idx) {
+            side[idx] = 0;
+            slot[idx] = PatternTable::weightSlot(idx, side[idx]);
+        }
+    }
+};
+static const SlotTable slots;
+
+static void addLine(const uint8_t* line, int n, float* f) {
+    for (int i = 0; i <= n - 5; ++i) {
+        bool leftOpen = (i > 0 && line[i - 1] == 0);
+        bool rightOpen = (i + 5 < n && line[i + 5] == 0);
+        int idx = PatternTable::index(PatternTable::window(line + i), leftOpen, rightOpen);
+        if (slots.slot[idx] >= 0) f[slots.slot[idx]] += static_cast<float>(slots.side[idx]);
+    }
+}
+
+// 與 SearchEngine::evaluateBoard 掃描相同的線
+template <int N>
+static void extractFeatures(const BasicBoard<N>& board, float* f) {
+    std::fill(f, f + STRIDE, 0.f);
+    uint8_t line[N], diag2[N];
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) line[j] = static_cast<uint8_t>(board.cellCode(i, j));
+        addLine(line, N, f);
+        for (int j = 0; j < N; ++j) line[j] = static_cast<uint8_t>(board.cellCode(j, i));
+        addLine(line, N, f);
+    }
+    for (int k = 4; k <= 2 * (N - 1) - 4; ++k) {
+        int n1 = 0, n2 = 0;
+        for (int i = 0; i < N; ++i) {
+            int j1 = k - i;
+            int j2 = i - (k - N + 1);
+            if (j1 >= 0 && j1 < N) line[n1++] = static_cast<uint8_t>(board.cellCode(i, j1));
+            if (j2 >= 0 && j2 < N) diag2[n2++] = static_cast<uint8_t>(board.cellCode(i, j2));
+        }
+        addLine(line, n1, f);
+        addLine(diag2, n2, f);
+    }
+}
+
+template <int N>
+static void sampleGame(const GameRecordReader::GameView& game, float target, const SampleOptions& options, Dataset& data) {
+    BasicBoard<N> board;
+    char turn = 'X';
+    for (int ply = 0; ply < game.moveCount(); ++ply) {
+        auto [r, c] = game.move(ply);
+        if (!board.placePiece(r, c, turn)) return; // 壞掉的棋譜
+        turn = (turn == 'X') ? 'O' : 'X';
+        if (ply + 1 < options.skip || (ply + 1) % options.every != 0) continue;
+        if (options.maxPositions && data.size() >= options.maxPositions) return;
+
+        size_t at = data.features.size();
+        data.features.resize(at + STRIDE);
+        extractFeatures(board, &data.features[at]);
+        data.targets.push_back(target);
+    }
+}
+
+static bool loadGames(const std::string& path, const SampleOptions& options, Dataset& data) {
+    GameRecordReader reader;
+    if (!reader.open(path)) return false;
+    GameRecordReader::GameView game;
+    while (reader.next(game)) {
+        float target;
+        switch (game.result()) {
+            case RecordResult::BlackWin: target = 1.f; break;
+            case RecordResult::WhiteWin: target = 0.f; break;
+            case RecordResult::Draw: target = 0.5f; break;
+            default: continue;
+        }
+        try {
+            dispatchBoardSize(game.boardSize(), [&](auto n) { sampleGame<decltype(n)::value>(game, target, options, data); });
+        } catch (const std::invalid_argument&) {
+        }
+        if (options.maxPositions && data.size() >= options.maxPositions) break;
+    }
+    return true;
+}
+
+// --- 平行批次評估 --- //
+// 損失 = 平均 (sigmoid(K * f·w) - y)^2；grad 不為 nullptr 時一併算出對 w 的梯度
+static double lossAndGradient(const Dataset& data, const float* w, double K, double* grad, int threads) {
+    const size_t n = data.size();
+    std::vector<double> partialLoss(threads, 0.0);
+    std::vector<double> partialGrad(static_cast<size_t>(threads) * STRIDE, 0.0);
+
+    auto worker = [&](int t) {
+        size_t begin = n * t / threads, end = n * (t + 1) / threads;
+        float g[STRIDE] = {};
+        double loss = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            const float* f = &data.features[i * STRIDE];
+            float e = 0.f;
+            for (int j = 0; j < STRIDE; ++j) e += f[j] * w[j];
+            double s = 1.0 / (1.0 + std::exp(-K * e));
+            double d = s - data.targets[i];
+            loss += d * d;
+            if (grad) {
+                float scale = static_cast<float>(2.0 * d * s * (1.0 - s) * K);
+                for (int j = 0; j < STRIDE; ++j) g[j] += scale * f[j];
+            }
+        }
+        partialLoss[t] = loss;
+        for (int j = 0; j < STRIDE; ++j) partialGrad[t * STRIDE + j] = g[j];
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+
+    double loss = 0.0;
+    for (double l : partialLoss) loss += l;
+    if (grad) {
+        std::fill(grad, grad + STRIDE, 0.0);
+        for (int t = 0; t < threads; ++t)
+            for (int j = 0; j < STRIDE; ++j) grad[j] += partialGrad[t * STRIDE + j] / n;
+    }
+    return loss / n;
+}
+
+// 先固定權重找最合適的 K（黃金分割搜尋 log10 K）
+static double fitK(const Dataset& data, const float* w, int threads) {
+    double lo = -8.0, hi = -1.0;
+    const double phi = (std::sqrt(5.0) - 1.0) / 2.0;
+    for (int it = 0; it < 40; ++it) {
+        double a = hi - phi * (hi - lo), b = lo + phi * (hi - lo);
+        if (lossAndGradient(data, w, std::pow(10.0, a), nullptr, threads) <
+            lossAndGradient(data, w, std::pow(10.0, b), nullptr, threads))
+            hi = b;
+        else
+            lo = a;
+    }
+    return std::pow(10.0, (lo + hi) / 2);
+}
+
+static void usage() {
+    std::cerr << "usage: eval_tuner <games.gmr>... -o <eval.params> [--init <eval.params>] [--iters <n>]\n"
+                 "                  [--threads <n>] [--skip <plies>] [--every <n>] [--max-positions <n>]\n";
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> inputs;
+    std::string output, init;
+    SampleOptions options;
+    int iterations = 300;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "-o") output = next();
+            else if (arg == "--init") init = next();
+            else if (arg == "--iters") iterations = std::stoi(next());
+            else if (arg == "--threads") threads = std::max(1, std::stoi(next()));
+            else if (arg == "--skip") options.skip = std::stoi(next());
+            else if (arg == "--every") options.every = std::max(1, std::stoi(next()));
+            else if (arg == "--max-positions") options.maxPositions = std::stoul(next());
+            else if (arg[0] != '-') inputs.push_back(arg);
+            else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 1;
+    }
+    if (inputs.empty() || output.empty()) {
+        usage();
+        return 1;
+    }
+
+    EvalWeights weights;
+    if (!init.empty() && !weights.load(init)) {
+        std::cerr << "Cannot load " << init << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Dataset data;
+    for (const auto& path : inputs) {
+        if (!loadGames(path, options, data)) {
+            std::cerr << "Cannot open " << path << "\n";
+            return 1;
+        }
+    }
+    if (data.size() == 0) {
+        std::cerr << "No positions with a known result\n";
+        return 1;
+    }
+    auto loaded = std::chrono::steady_clock::now();
+    std::cout << "positions: " << data.size() << " ("
+              << std::chrono::duration_cast<std::chrono::milliseconds>(loaded - start).count() << " ms)\n";
+
+    // 以 log(w) 為變數做 Adam：權重保持為正，每步約為相對變化
+    float w[STRIDE] = {};
+    double theta[EvalWeights::COUNT], m[EvalWeights::COUNT] = {}, v[EvalWeights::COUNT] = {};
+    for (int j = 0; j < EvalWeights::COUNT; ++j) {
+        w[j] = static_cast<float>(std::max(1, weights.value[j]));
+        theta[j] = std::log(static_cast<double>(w[j]));
+    }
+
+    const double K = fitK(data, w, threads);
+    const double initialLoss = lossAndGradient(data, w, K, nullptr, threads);
+    std::cout << "K = " << K << "  initial loss = " << initialLoss << "\n";
+
+    const double rate = 0.02, beta1 = 0.9, beta2 = 0.999, epsilon = 1e-12;
+    double grad[STRIDE];
+    double loss = initialLoss;
+    for (int it = 1; it <= iterations; ++it) {
+        loss = lossAndGradient(data, w, K, grad, threads);
+        for (int j = 0; j < EvalWeights::COUNT; ++j) {
+            double g = grad[j] * w[j]; // d loss / d log(w)
+            m[j] = beta1 * m[j] + (1 - beta1) * g;
+            v[j] = beta2 * v[j] + (1 - beta2) * g * g;
+            double mHat = m[j] / (1 - std::pow(beta1, it));
+            double vHat = v[j] / (1 - std::pow(beta2, it));
+            theta[j] -= rate * mHat / (std::sqrt(vHat) + epsilon);
+            w[j] = static_cast<float>(std::exp(theta[j]));
+        }
+        if (it % 50 == 0 || it == iterations) std::cout << "iter " << it << "  loss = " << loss << "\n";
+    }
+
+    for (int j = 0; j < EvalWeights::COUNT; ++j) weights.value[j] = std::max(1, static_cast<int>(std::lround(w[j])));
+    if (!weights.save(output)) {
+        std::cerr << "Cannot write " << output << "\n";
+        return 1;
+    }
+    std::cout << "loss " << initialLoss << " -> " << loss << ", wrote " << output << " ("
+              << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loaded).count()
+              << " ms)\n";
+    return 0;
+}
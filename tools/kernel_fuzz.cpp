@@ -0,0 +1,629 @@
+// 核心差分測試
+//
+//   kernel_fuzz [--positions 100000] [--size 15] [--seed 1] [--threads N] [--kernels win,hash,...]
+//
+// 隨機對局夾雜隨機的落子 / 提子（含後進先出的還原與任意位置的提子），每一步都把引擎裡
+// 最佳化過的核心和 ReferenceKernels 的參考實作比對：
+//   win        Board::isWin 與三種規則的 isWin、isFull
+//   hash       增量維護的對稱雜湊、hashPosition 與參考雜湊；對稱後的局面標準形相同
+//   eval       SearchEngine::evaluateBoard（查表）與直接依權重計分
+//   moves      generateMoves（自由規則與連珠黑棋）
+//   forbidden  連珠禁手查表（從盤面編碼、增量單線編碼）與直接試下，抽查最後一手所在四條線上的空點
+//   threats    findWinningMoveIfAvailable、findBlockingMoveIfThreat（自由規則與連珠）
+//   potential  增量更新的潛力圖與從頭計算
+//   nnue       增量累加器與從頭計算、AVX2 與純量推論（隨機網路）
+//   sparse     同一局面的 N x N 有限 SparseBoard：SparseSearchEngine 的評估、候選步（自由規則與連珠黑棋）
+//              與三種規則的 isWin，和 SearchEngine<N> / BasicBoard<N> 比對
+//   ttfile     置換表存檔的來回：盤面第一次到 8 子時以存檔的表淺層搜尋，換一個引擎接回同一個檔案重搜，
+//              分數必須相同且有置換表命中（較慢，每盤只做一次）
+// 發現不一致時把操作序列縮到仍會出錯的最短版本再印出，結束碼為 1
+#include "GameRecord.hpp"
+#include "ReferenceKernels.hpp"
+#include "SearchEngine.hpp"
+#include "SparseSearchEngine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum Kernel { WIN, HASH, EVAL, MOVES, FORBIDDEN, THREATS, POTENTIAL, NNUE, SPARSE, TTFILE, KERNEL_COUNT };
+static const char* KERNEL_NAMES[KERNEL_COUNT] = {"win",     "hash",      "eval", "moves",  "forbidden",
+                                                 "threats", "potential", "nnue", "sparse", "ttfile"};
+static const unsigned ALL_KERNELS = (1u << KERNEL_COUNT) - 1;
+
+struct Op {
+    int row, col;
+    char symbol; // 'X' / 'O' 為落子，'.' 為提子
+};
+
+struct Mismatch {
+    int kernel;
+    std::string detail;
+};
+
+struct Failure {
+    Mismatch mismatch;
+    std::vector<Op> ops;
+    size_t originalLength = 0;
+    uint64_t seed = 0;
+};
+
+static std::string cellText(int size, int row, int col) {
+    GameRecord one;
+    one.boardSize = size;
+    one.moves.emplace_back(row, col);
+    return formatMoveText(one);
+}
+
+template <int N>
+static std::string movesText(const std::vector<std::pair<int, int>>& moves) {
+    std::string text;
+    for (auto [r, c] : moves) text += (text.empty() ? "" : " ") + cellText(N, r, c);
+    return text.empty() ? "(none)" : text;
+}
+
+template <int N>
+static std::string optionalText(const std::optional<std::pair<int, int>>& move) {
+    return move ? cellText(N, move->first, move->second) : "none";
+}
+
+template <int N>
+class Fuzzer {
+public:
+    explicit Fuzzer(unsigned kernels)
+        : kernels(kernels), freeX('X', 1), freeO('O', 1), renjuX('X', 1), renjuO('O', 1), sparseBoard(N),
+          sparseFree('X', 1), sparseRenju('X', 1) {
+        network.randomize(N, 7);
+        reset();
+    }
+
+    // 隨機產生 count 個局面並逐一比對；發現不一致時縮小序列、寫入 failure 並回傳 false
+    bool run(uint64_t seed, long long count, const std::atomic<bool>& stop, std::atomic<long long>& done, Failure& failure) {
+        std::mt19937_64 rng(seed);
+        std::vector<Op> ops, stack;
+        bool undoNext = false;
+        long long local = 0;
+        reset();
+
+        for (long long i = 0; i < count && !stop; ++i) {
+            Op op = nextOp(rng, stack, undoNext);
+            undoNext = false;
+            if (!apply(op)) continue;
+            ops.push_back(op);
+
+            if (auto m = check(op, kernels)) {
+                done += local;
+                failure.seed = seed;
+                failure.originalLength = ops.size();
+                failure.ops = shrink(ops, 1u << m->kernel);
+                failure.mismatch = *replay(failure.ops, 1u << m->kernel);
+                return false;
+            }
+            if (++local == 4096) {
+                done += local;
+                local = 0;
+            }
+
+            // 分出勝負後一半機率悔棋、一半換新的一盤；盤面太滿或序列太長也換一盤
+            bool won = op.symbol != '.' && board.isWin(op.row, op.col, op.symbol);
+            if (won && (rng() & 1)) {
+                undoNext = true;
+            } else if (won || stones[0] + stones[1] > N * N * 3 / 5 || ops.size() > static_cast<size_t>(4 * N * N)) {
+                reset();
+                ops.clear();
+                stack.clear();
+            }
+        }
+        done += local;
+        return true;
+    }
+
+    // 從空盤重播 ops（不合法的操作略過），每步都檢查，回傳第一個不一致
+    std::optional<Mismatch> replay(const std::vector<Op>& ops, unsigned mask) {
+        reset();
+        for (const Op& op : ops) {
+            if (!apply(op)) continue;
+            if (auto m = check(op, mask)) return m;
+        }
+        return std::nullopt;
+    }
+
+    // 逐段刪除操作（段長由一半縮到 1），只要同一個核心仍然出錯就保留刪除
+    std::vector<Op> shrink(std::vector<Op> ops, unsigned mask) {
+        thorough = true;
+        for (size_t chunk = std::max<size_t>(1, ops.size() / 2); chunk >= 1;) {
+            bool progress = false;
+            for (size_t at = 0; at < ops.size();) {
+                std::vector<Op> candidate(ops.begin(), ops.begin() + at);
+                candidate.insert(candidate.end(), ops.begin() + std::min(ops.size(), at + chunk), ops.end());
+                if (replay(candidate, mask)) {
+                    ops = std::move(candidate);
+                    progress = true;
+                } else {
+                    at += chunk;
+                }
+            }
+            if (!progress) {
+                if (chunk == 1) break;
+                chunk /= 2;
+            }
+        }
+        return ops;
+    }
+
+private:
+    unsigned kernels;
+    bool thorough = false;
+    BasicBoard<N> board;
+    int stones[2] = {0, 0};
+    SymmetricHash<N> hash;
+    PotentialMap<N> potential, freshPotential;
+    LineCodes<N> lines;
+    NnueNetwork network;
+    NnueNetwork::Accumulator acc, freshAcc;
+    SearchEngine<N, FreestyleRule> freeX, freeO;
+    SearchEngine<N, RenjuRule> renjuX, renjuO;
+    SparseBoard sparseBoard; // 與 board 同步的稀疏版本
+    SparseSearchEngine<FreestyleRule> sparseFree;
+    SparseSearchEngine<RenjuRule> sparseRenju;
+    const EvalWeights weights;
+
+    void reset() {
+        board.reset();
+        sparseBoard.reset();
+        stones[0] = stones[1] = 0;
+        hash = SymmetricHash<N>();
+        potential.refresh(board);
+        lines.refresh(board);
+        network.refresh(board, acc);
+    }
+
+    bool apply(const Op& op) {
+        if (op.row < 0 || op.row >= N || op.col < 0 || op.col >= N) return false;
+        char symbol = op.symbol;
+        if (symbol == '.') {
+            symbol = board.getCell(op.row, op.col);
+            if (symbol == '.') return false;
+            board.removePiece(op.row, op.col);
+            sparseBoard.removePiece(op.row, op.col);
+            network.sub(acc, op.row * N + op.col, symbol == 'X' ? 0 : 1);
+            stones[symbol == 'X' ? 0 : 1]--;
+        } else {
+            if (!board.placePiece(op.row, op.col, symbol)) return false;
+            sparseBoard.placePiece(op.row, op.col, symbol);
+            network.add(acc, op.row * N + op.col, symbol == 'X' ? 0 : 1);
+            stones[symbol == 'X' ? 0 : 1]++;
+        }
+        hash.toggle(op.row, op.col, symbol);
+        potential.update(board, op.row, op.col);
+        lines.update(board, op.row, op.col);
+        return true;
+    }
+
+    // 多半下在既有棋子附近，才會常常出現連線與禁手；偶爾還原最後一手或任意提子
+    Op nextOp(std::mt19937_64& rng, std::vector<Op>& stack, bool undo) {
+        int roll = static_cast<int>(rng() % 100);
+        if (!stack.empty() && (undo || roll < 12)) {
+            Op top = stack.back();
+            stack.pop_back();
+            return {top.row, top.col, '.'};
+        }
+        if (!stack.empty() && roll < 17) {
+            size_t k = rng() % stack.size();
+            Op pick = stack[k];
+            stack.erase(stack.begin() + k);
+            return {pick.row, pick.col, '.'};
+        }
+
+        const char mover = stones[0] == stones[1] ? 'X' : 'O';
+        for (int attempt = 0; attempt < 16; ++attempt) {
+            int r, c;
+            if (!stack.empty() && roll < 90) {
+                const Op& near = stack[rng() % stack.size()];
+                r = near.row + static_cast<int>(rng() % 5) - 2;
+                c = near.col + static_cast<int>(rng() % 5) - 2;
+            } else {
+                r = static_cast<int>(rng() % N);
+                c = static_cast<int>(rng() % N);
+            }
+            if (r < 0 || r >= N || c < 0 || c >= N || board.getCell(r, c) != '.') continue;
+            stack.push_back({r, c, mover});
+            return stack.back();
+        }
+        return {-1, -1, mover}; // 找不到空位，apply 會略過
+    }
+
+    // 平常依子數奇偶輪流比對整盤掃描的核心、禁手只抽查幾點；
+    // 縮小序列時改成全部都查，刪掉操作才不會因為抽到別的點而看不到原本的錯誤
+    std::optional<Mismatch> check(const Op& last, unsigned mask) {
+        if (!thorough) return checkOnce(last, mask, (stones[0] + stones[1]) % 2 != 0, false);
+        if (auto m = checkOnce(last, mask, false, true)) return m;
+        return checkOnce(last, mask, true, true);
+    }
+
+    std::optional<Mismatch> checkOnce(const Op& last, unsigned mask, bool odd, bool allCells) {
+        const char mover = stones[0] == stones[1] ? 'X' : 'O';
+
+        if ((mask & (1u << WIN)) && last.symbol != '.') {
+            const int r = last.row, c = last.col;
+            const char s = last.symbol;
+            bool expect = ReferenceKernels::isWin(board, r, c, s);
+            bool standard = ReferenceKernels::ruleWin<N, StandardRule>(board, r, c, s);
+            bool renju = ReferenceKernels::ruleWin<N, RenjuRule>(board, r, c, s);
+            if (board.isWin(r, c, s) != expect || FreestyleRule::isWin(board, r, c, s) != expect ||
+                StandardRule::isWin(board, r, c, s) != standard || RenjuRule::isWin(board, r, c, s) != renju ||
+                board.isFull() != (stones[0] + stones[1] == N * N)) {
+                std::ostringstream out;
+                out << "isWin at " << cellText(N, r, c) << ": reference freestyle=" << expect << " standard=" << standard
+                    << " renju=" << renju << ", got " << board.isWin(r, c, s) << "/" << StandardRule::isWin(board, r, c, s)
+                    << "/" << RenjuRule::isWin(board, r, c, s) << " (isFull " << board.isFull() << ")";
+                return Mismatch{WIN, out.str()};
+            }
+        }
+
+        if (mask & (1u << HASH)) {
+            SymmetricHash<N> full = hashPosition(board), reference = ReferenceKernels::hash(board);
+            for (int k = 0; k < 8; ++k) {
+                if (hash.h[k] != reference.h[k] || full.h[k] != reference.h[k]) {
+                    std::ostringstream out;
+                    out << "symmetry " << k << ": incremental " << hash.h[k] << ", hashPosition " << full.h[k]
+                        << ", reference " << reference.h[k];
+                    return Mismatch{HASH, out.str()};
+                }
+            }
+            // 把局面做一次對稱變換，標準形必須不變
+            int k = (stones[0] + stones[1]) % 8;
+            BasicBoard<N> transformed;
+            for (int r = 0; r < N; ++r)
+                for (int c = 0; c < N; ++c)
+                    if (board.getCell(r, c) != '.') {
+                        auto [tr, tc] = applySymmetry<N>(k, r, c);
+                        transformed.placePiece(tr, tc, board.getCell(r, c));
+                    }
+            if (ReferenceKernels::hash(transformed).canonical() != hash.canonical()) {
+                std::ostringstream out;
+                out << "canonical hash changes under symmetry " << k;
+                return Mismatch{HASH, out.str()};
+            }
+        }
+
+        if (mask & (1u << EVAL)) {
+            int expect = ReferenceKernels::evaluate(board, weights);
+            int got = odd ? -freeO.evaluate(board) : freeX.evaluate(board);
+            if (got != expect) {
+                std::ostringstream out;
+                out << "evaluateBoard (" << (odd ? 'O' : 'X') << "): reference " << expect << ", got " << got << " from X's side";
+                return Mismatch{EVAL, out.str()};
+            }
+        }
+
+        if (mask & (1u << MOVES)) {
+            auto expect = ReferenceKernels::candidateMoves<N, FreestyleRule>(board, mover);
+            if (!odd) {
+                auto got = candidates(freeX, mover);
+                if (got != expect) {
+                    std::ostringstream out;
+                    out << "generateMoves (freestyle, " << mover << "): reference " << movesText<N>(expect) << ", got "
+                        << movesText<N>(got);
+                    return Mismatch{MOVES, out.str()};
+                }
+            } else {
+                // 連珠黑棋：少掉的必須正好是禁手點（禁手判斷本身由 forbidden 核心驗證）
+                expect.erase(std::remove_if(expect.begin(), expect.end(),
+                                            [&](auto m) { return RenjuRule::isForbidden(board, m.first, m.second, 'X'); }),
+                             expect.end());
+                auto got = candidates(renjuX, 'X');
+                if (got != expect) {
+                    std::ostringstream out;
+                    out << "generateMoves (renju, X): expected " << movesText<N>(expect) << ", got " << movesText<N>(got);
+                    return Mismatch{MOVES, out.str()};
+                }
+            }
+        }
+
+        if (mask & (1u << FORBIDDEN)) {
+            // 最後一手所在四條線上前後 4 格的空點，平常依雜湊挑 4 個（重播時挑到同樣的點），縮小時全查
+            std::pair<int, int> cells[32];
+            int n = 0;
+            for (auto& d : ReferenceKernels::DIRS)
+                for (int i = -4; i <= 4; ++i) {
+                    int r = last.row + d[0] * i, c = last.col + d[1] * i;
+                    if (ReferenceKernels::inside<N>(r, c) && board.getCell(r, c) == '.') cells[n++] = {r, c};
+                }
+            uint64_t pick = hash.h[0];
+            for (int j = 0; j < (allCells ? n : std::min(n, 4)); ++j, pick /= 31) {
+                auto [r, c] = cells[allCells ? j : pick % n];
+                bool expect = ReferenceKernels::isForbidden(board, r, c, 'X');
+                if (RenjuRule::isForbidden(board, r, c, 'X') != expect || RenjuRule::isForbidden(lines, r, c, 'X') != expect) {
+                    std::ostringstream out;
+                    out << "isForbidden at " << cellText(N, r, c) << ": reference " << expect << ", board "
+                        << RenjuRule::isForbidden(board, r, c, 'X') << ", line codes " << RenjuRule::isForbidden(lines, r, c, 'X');
+                    return Mismatch{FORBIDDEN, out.str()};
+                }
+                for (int d = 0; d < 4; ++d) {
+                    int full = LinePatterns::encode(board, r, c, LinePatterns::DIRS[d][0], LinePatterns::DIRS[d][1], 1);
+                    if (lines.code(d, r, c) != full) {
+                        std::ostringstream out;
+                        out << "line code " << d << " at " << cellText(N, r, c) << ": incremental " << lines.code(d, r, c)
+                            << ", encode " << full;
+                        return Mismatch{FORBIDDEN, out.str()};
+                    }
+                }
+            }
+        }
+
+        if (mask & (1u << THREATS)) {
+            std::optional<std::string> m;
+            if (!odd) m = threats<FreestyleRule>(mover == 'X' ? freeX : freeO, mover);
+            else m = threats<RenjuRule>(mover == 'X' ? renjuX : renjuO, mover);
+            if (m) return Mismatch{THREATS, *m};
+        }
+
+        if (mask & (1u << POTENTIAL)) {
+            freshPotential.refresh(board);
+            int32_t got[N * N], expect[N * N];
+            for (int side = 1; side <= 2; ++side) {
+                potential.combine(side, got);
+                freshPotential.combine(side, expect);
+                for (int i = 0; i < N * N; ++i) {
+                    if (got[i] != expect[i]) {
+                        std::ostringstream out;
+                        out << "potential (" << (side == 1 ? 'X' : 'O') << ") at " << cellText(N, i / N, i % N)
+                            << ": incremental " << got[i] << ", refresh " << expect[i];
+                        return Mismatch{POTENTIAL, out.str()};
+                    }
+                }
+            }
+        }
+
+        if (mask & (1u << NNUE)) {
+            network.refresh(board, freshAcc);
+            if (!std::equal(acc.v, acc.v + NnueNetwork::HIDDEN, freshAcc.v)) {
+                std::ostringstream out;
+                out << "accumulator differs from refresh";
+                return Mismatch{NNUE, out.str()};
+            }
+            int simd = network.evaluate(acc);
+            network.setSimd(false);
+            int scalar = network.evaluate(acc);
+            network.setSimd(true);
+            if (simd != scalar) {
+                std::ostringstream out;
+                out << "network output: SIMD " << simd << ", scalar " << scalar;
+                return Mismatch{NNUE, out.str()};
+            }
+        }
+
+        if (mask & (1u << SPARSE)) {
+            if (auto m = sparse(last)) return Mismatch{SPARSE, *m};
+        }
+
+        if ((mask & (1u << TTFILE)) && last.symbol != '.' && stones[0] + stones[1] == 8) {
+            if (auto m = tableFile(mover)) return Mismatch{TTFILE, *m};
+        }
+        return std::nullopt;
+    }
+
+    // 兩個引擎先後接同一個檔案搜同一個局面；第二次的表已經有第一次的結果
+    std::optional<std::string> tableFile(char mover) {
+        const std::string path =
+            (std::filesystem::temp_directory_path() / ("kernel_fuzz_" + std::to_string(reinterpret_cast<uintptr_t>(this)) + ".tt"))
+                .string();
+        std::filesystem::remove(path);
+        SearchResult result[2];
+        for (int run = 0; run < 2; ++run) {
+            SearchEngine<N, FreestyleRule> engine(mover, 1);
+            engine.setDepth(2);
+            engine.setThreads(1);
+            engine.setTimeLimit(std::chrono::milliseconds(60000));
+            if (!engine.attachTableFile(path)) {
+                std::filesystem::remove(path);
+                return "attachTableFile failed on run " + std::to_string(run + 1);
+            }
+            BasicBoard<N> copy = board;
+            result[run] = engine.analyze(copy);
+            engine.detachTableFile();
+        }
+        std::filesystem::remove(path);
+        if (std::string(result[0].source) != "search") return std::nullopt; // 開局庫 / 必勝 / 必擋不經過置換表
+
+        if (result[1].score != result[0].score || result[1].ttHits == 0) {
+            std::ostringstream out;
+            out << "table file round trip (" << mover << "): score " << result[0].score << " -> " << result[1].score
+                << ", second run tt hits " << result[1].ttHits << ", nodes " << result[0].nodes << " -> " << result[1].nodes;
+            return out.str();
+        }
+        return std::nullopt;
+    }
+
+    // 稀疏棋盤在 N x N 有界時必須和密集棋盤完全一致；空盤時稀疏版本回傳天元，不比候選步
+    std::optional<std::string> sparse(const Op& last) {
+        const char mover = stones[0] == stones[1] ? 'X' : 'O';
+        int expect = freeX.evaluate(board), got = sparseFree.evaluateBoard(sparseBoard);
+        if (got != expect) {
+            std::ostringstream out;
+            out << "sparse evaluateBoard: SearchEngine " << expect << ", sparse " << got;
+            return out.str();
+        }
+
+        if (stones[0] + stones[1] > 0) {
+            std::vector<std::pair<int, int>> sparseMoves;
+            sparseFree.generateMoves(sparseBoard, sparseMoves, mover);
+            auto expectMoves = candidates(freeX, mover);
+            std::sort(sparseMoves.begin(), sparseMoves.end());
+            if (sparseMoves != expectMoves) {
+                std::ostringstream out;
+                out << "sparse generateMoves (freestyle, " << mover << "): SearchEngine " << movesText<N>(expectMoves)
+                    << ", sparse " << movesText<N>(sparseMoves);
+                return out.str();
+            }
+            sparseRenju.generateMoves(sparseBoard, sparseMoves, 'X');
+            expectMoves = candidates(renjuX, 'X');
+            std::sort(sparseMoves.begin(), sparseMoves.end());
+            if (sparseMoves != expectMoves) {
+                std::ostringstream out;
+                out << "sparse generateMoves (renju, X): SearchEngine " << movesText<N>(expectMoves) << ", sparse "
+                    << movesText<N>(sparseMoves);
+                return out.str();
+            }
+        }
+
+        if (last.symbol != '.') {
+            const int r = last.row, c = last.col;
+            const char s = last.symbol;
+            if (FreestyleRule::isWin(sparseBoard, r, c, s) != FreestyleRule::isWin(board, r, c, s) ||
+                StandardRule::isWin(sparseBoard, r, c, s) != StandardRule::isWin(board, r, c, s) ||
+                RenjuRule::isWin(sparseBoard, r, c, s) != RenjuRule::isWin(board, r, c, s)) {
+                std::ostringstream out;
+                out << "sparse isWin at " << cellText(N, r, c) << " differs from BasicBoard";
+                return out.str();
+            }
+        }
+        return std::nullopt;
+    }
+
+    template <class Engine>
+    std::vector<std::pair<int, int>> candidates(Engine& engine, char mover) {
+        typename Engine::MoveList moves;
+        BasicBoard<N> copy = board;
+        engine.candidateMoves(copy, moves, mover);
+        std::vector<std::pair<int, int>> sorted(moves.begin(), moves.end());
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    }
+
+    // 引擎回傳的獲勝點只要確實能贏即可（順序屬於實作細節）；擋點的掃描順序是規格，需完全相同
+    template <class Rule, class Engine>
+    std::optional<std::string> threats(Engine& engine, char mover) {
+        BasicBoard<N> copy = board;
+        auto win = engine.findWinningMoveIfAvailable(copy);
+        auto expectWin = ReferenceKernels::winningMove<N, Rule>(board, mover);
+        bool winOk = win.has_value() == expectWin.has_value();
+        if (win && winOk) {
+            BasicBoard<N> after = board;
+            winOk = after.placePiece(win->first, win->second, mover) &&
+                    ReferenceKernels::ruleWin<N, Rule>(after, win->first, win->second, mover);
+        }
+        if (!winOk) {
+            std::ostringstream out;
+            out << "findWinningMoveIfAvailable (" << Rule::name << ", " << mover << "): reference "
+                << optionalText<N>(expectWin) << ", got " << optionalText<N>(win);
+            return out.str();
+        }
+
+        auto block = engine.findBlockingMoveIfThreat(copy);
+        auto expectBlock = ReferenceKernels::blockingMove<N, Rule>(board, mover);
+        if (block != expectBlock) {
+            std::ostringstream out;
+            out << "findBlockingMoveIfThreat (" << Rule::name << ", " << mover << "): reference "
+                << optionalText<N>(expectBlock) << ", got " << optionalText<N>(block);
+            return out.str();
+        }
+        return std::nullopt;
+    }
+};
+
+static std::string opsText(int size, const std::vector<Op>& ops) {
+    std::string text;
+    for (const Op& op : ops) {
+        if (!text.empty()) text += ' ';
+        text += op.symbol == '.' ? '-' : op.symbol;
+        text += cellText(size, op.row, op.col);
+    }
+    return text;
+}
+
+static void usage() {
+    std::cerr << "usage: kernel_fuzz [--positions <n>] [--size 15|19] [--seed <n>] [--threads <n>]\n"
+                 "                   [--kernels win,hash,eval,moves,forbidden,threats,potential,nnue,sparse,ttfile]\n";
+}
+
+template <int N>
+static int fuzz(long long positions, uint64_t seed, int threads, unsigned kernels) {
+    std::atomic<bool> stop{false};
+    std::atomic<long long> done{0};
+    std::mutex failureMutex;
+    std::optional<Failure> firstFailure;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            Fuzzer<N> fuzzer(kernels);
+            Failure failure;
+            long long share = positions / threads + (t < positions % threads ? 1 : 0);
+            if (fuzzer.run(seed + t, share, stop, done, failure)) return;
+            stop = true;
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!firstFailure) firstFailure = std::move(failure);
+        });
+    }
+    for (auto& th : pool) th.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "checked " << done.load() << " positions in " << seconds << " s ("
+              << static_cast<long long>(done.load() / std::max(seconds, 1e-9)) << "/s, " << threads << " threads)\n";
+    if (!firstFailure) {
+        std::cout << "all kernels agree with the reference\n";
+        return 0;
+    }
+
+    const Failure& f = *firstFailure;
+    std::cout << "MISMATCH in " << KERNEL_NAMES[f.mismatch.kernel] << ": " << f.mismatch.detail << "\n"
+              << "seed " << f.seed << ", shrunk from " << f.originalLength << " to " << f.ops.size() << " operations:\n  "
+              << opsText(N, f.ops) << "\n";
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    long long positions = 100000; // 參考實作每核心每秒約 7k 個局面，預設一核心十幾秒
+    int size = 15;
+    uint64_t seed = 1;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned kernels = ALL_KERNELS;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "--positions") positions = std::stoll(next());
+            else if (arg == "--size") size = std::stoi(next());
+            else if (arg == "--seed") seed = std::stoull(next());
+            else if (arg == "--threads") threads = std::max(1, std::stoi(next()));
+            else if (arg == "--kernels") {
+                kernels = 0;
+                std::istringstream list(next());
+                std::string name;
+                while (std::getline(list, name, ',')) {
+                    int k = 0;
+                    while (k < KERNEL_COUNT && name != KERNEL_NAMES[k]) ++k;
+                    if (k == KERNEL_COUNT) {
+                        std::cerr << "Unknown kernel " << name << "\n";
+                        return 1;
+                    }
+                    kernels |= 1u << k;
+                }
+            } else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 1;
+    }
+
+    try {
+        return dispatchBoardSize(size, [&](auto n) { return fuzz<decltype(n)::value>(positions, seed, threads, kernels); });
+    } catch (const std::invalid_argument&) {
+        std::cerr << "Unsupported board size " << size << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,148 @@
+// 神經網路評估檔工具
+//
+//   nnue_tool init -o <eval.nnue> [--size 15] [--seed 1]   產生隨機小權重的網路（格式與流程測試用）
+//   nnue_tool check <eval.nnue> [--positions 20000]        比對增量更新 / 從頭計算、AVX2 / 純量的結果，並量測評估速度
+//
+// 引擎在工作目錄下找到 eval.nnue 時改用網路評估（AIPlayer、pbrain-gomoku），
+// batch_analyze 則以 --nnue 指定
+#include "Nnue.hpp"
+#include "PatternTable.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void usage() {
+    std::cerr << "usage: nnue_tool init -o <eval.nnue> [--size 15|19] [--seed <n>]\n"
+                 "       nnue_tool check <eval.nnue> [--positions <n>]\n";
+}
+
+template <int N>
+static int check(NnueNetwork& net, int positions) {
+    std::mt19937 rng(12345);
+    std::vector<std::pair<int, int>> moves;
+    long long mismatches = 0, leaves = 0;
+    NnueNetwork::Accumulator acc, fresh;
+
+    for (int p = 0; p < positions; ++p) {
+        BasicBoard<N> board;
+        net.refresh(board, acc);
+        moves.clear();
+
+        // 隨機落子再隨機提子，每一步都和從頭計算的累加器比對
+        int plies = static_cast<int>(rng() % (N * N / 2));
+        for (int i = 0; i < plies; ++i) {
+            int r = static_cast<int>(rng() % N), c = static_cast<int>(rng() % N);
+            int color = i % 2;
+            if (!board.placePiece(r, c, color ? 'O' : 'X')) continue;
+            net.add(acc, r * N + c, color);
+            moves.emplace_back(r * N + c, color);
+        }
+        for (int i = 0; i < static_cast<int>(moves.size()) / 3; ++i) {
+            auto [cell, color] = moves.back();
+            moves.pop_back();
+            board.removePiece(cell / N, cell % N);
+            net.sub(acc, cell, color);
+        }
+
+        net.refresh(board, fresh);
+        bool same = std::equal(acc.v, acc.v + NnueNetwork::HIDDEN, fresh.v);
+        int simdScore = net.evaluate(acc);
+        net.setSimd(false);
+        int scalarScore = net.evaluate(acc);
+        net.setSimd(true);
+        if (!same || simdScore != scalarScore) ++mismatches;
+        ++leaves;
+    }
+    std::cout << "checked " << leaves << " positions, mismatches: " << mismatches
+              << (NnueNetwork::simdSupported() ? " (AVX2 vs scalar)" : " (AVX2 unavailable, scalar only)") << "\n";
+
+    // 速度：葉節點評估（網路只需推論；棋型表需掃描整盤）
+    BasicBoard<N> board;
+    for (int i = 0; i < N * N / 4; ++i) board.placePiece(static_cast<int>(rng() % N), static_cast<int>(rng() % N), i % 2 ? 'O' : 'X');
+    net.refresh(board, acc);
+    PatternTable patterns;
+    const int ROUNDS = 200000;
+    volatile int sink = 0;
+
+    for (bool simd : {false, true}) {
+        if (simd && !NnueNetwork::simdSupported()) continue;
+        net.setSimd(simd);
+        auto start = Clock::now();
+        for (int i = 0; i < ROUNDS; ++i) {
+            NnueNetwork::Accumulator child = acc;
+            net.add(child, i % (N * N), i & 1);
+            sink = sink + net.evaluate(child);
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ROUNDS;
+        std::cout << (simd ? "network (AVX2):   " : "network (scalar): ") << ns << " ns/leaf\n";
+    }
+
+    uint8_t line[N];
+    auto start = Clock::now();
+    for (int i = 0; i < ROUNDS / 10; ++i) {
+        int score = 0;
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) line[c] = static_cast<uint8_t>(board.cellCode(r, c));
+            score += patterns.evaluateLine(line, N);
+        }
+        sink = sink + score;
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (ROUNDS / 10);
+    std::cout << "pattern rows only: " << ns << " ns/leaf (full evaluation scans 4 directions)\n";
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    std::string command = argv[1], input, output;
+    int size = 15, positions = 20000;
+    uint64_t seed = 1;
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "-o") output = next();
+            else if (arg == "--size") size = std::stoi(next());
+            else if (arg == "--seed") seed = std::stoull(next());
+            else if (arg == "--positions") positions = std::stoi(next());
+            else if (arg[0] != '-' && input.empty()) input = arg;
+            else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 1;
+    }
+
+    NnueNetwork net;
+    if (command == "init" && !output.empty()) {
+        net.randomize(size, seed);
+        if (!net.save(output)) {
+            std::cerr << "Cannot write " << output << "\n";
+            return 1;
+        }
+        std::cout << "wrote " << output << " (" << size << "x" << size << ")\n";
+        return 0;
+    }
+    if (command == "check" && !input.empty()) {
+        if (!net.load(input)) return 1;
+        try {
+            return dispatchBoardSize(net.boardSize(), [&](auto n) { return check<decltype(n)::value>(net, positions); });
+        } catch (const std::invalid_argument&) {
+            std::cerr << "Unsupported board size " << net.boardSize() << "\n";
+            return 1;
+        }
+    }
+    usage();
+    return 1;
+}
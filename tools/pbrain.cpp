@@ -0,0 +1,490 @@
+// Gomocup / Piskvork 協定前端（標準輸入輸出）
+//
+//   pbrain-gomoku [--sparse] [--record <games.gmr>] [--tt-file <path>]
+//
+// 支援 START、RESTART、BEGIN、TURN、BOARD、TAKEBACK、INFO、ABOUT、END。
+// 執行檔依慣例命名為 pbrain-gomoku，可直接掛到 Piskvork 或其他 Gomocup 管理程式。
+//
+//  - 15 / 19 路用 SearchEngine；其他大小（例如 Gomocup 的 20 路）或加上 --sparse 時改用
+//    SparseBoard + SparseSearchEngine，不背景思考，也不讀開局庫、權重與網路檔
+//  - INFO timeout_turn / timeout_match / time_left 換算成每步的思考時間，並保留回覆餘裕
+//  - INFO max_memory 換算成置換表大小
+//  - 輪到對手時在背景以預測的應手繼續搜尋（置換表不清空），收到任何指令就先停下再處理
+//  - --record 把每一盤逐步追加到棋譜檔（只支援 15 / 19 路），分出勝負或下滿時寫入結果
+//  - --tt-file 把置換表存到 <path>.<大小><執子>（例如 analysis.tt.15X），下次同樣的設定接續使用；
+//    稀疏引擎不支援
+#include "GameRecord.hpp"
+#include "OpeningBook.hpp"
+#include "SearchEngine.hpp"
+#include "SparseSearchEngine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// 比賽設定（毫秒 / 位元組；0 代表未限制）
+struct Limits {
+    long long turnMs = 5000;
+    long long matchMs = 0;
+    long long leftMs = 0;
+    bool leftKnown = false;
+    long long maxMemory = 0;
+};
+
+// 置換表佔記憶體上限的一半，其餘留給程式本體、棋型表與執行緒堆疊
+static size_t tableSizeFor(long long bytes) {
+    if (bytes <= 0) return 64;
+    size_t mb = static_cast<size_t>(bytes / 2 / (1024 * 1024));
+    return std::max<size_t>(1, std::min<size_t>(mb, 1024));
+}
+
+// 依棋盤大小實例化的對局狀態；座標一律是 (row, col)，協定的 x 是欄、y 是列
+class Session {
+public:
+    virtual ~Session() {}
+    virtual void reset() = 0;
+    virtual bool place(int row, int col, bool own) = 0;
+    virtual bool takeback(int row, int col) = 0;
+    virtual std::pair<int, int> think(long long budgetMs) = 0;
+    virtual void startPonder() = 0;
+    virtual void stopPonder() = 0;
+    virtual void setMemory(long long bytes) = 0;
+    virtual void setTableFile(const std::string& path) = 0;
+};
+
+template <int N>
+class SessionImpl : public Session {
+public:
+    SessionImpl() {
+        book.open("opening.book");
+        hasWeights = weights.load("eval.params");
+        hasNetwork = network.load("eval.nnue") && network.boardSize() == N;
+        probCut.load("probcut.params"); // 沒有檔案就維持不啟用
+    }
+    ~SessionImpl() override {
+        stopPonder();
+        if (engine) engine->flushTableFile();
+    }
+
+    void reset() override {
+        stopPonder();
+        board = BasicBoard<N>();
+        ownStones = oppStones = 0;
+        lastPV.clear();
+    }
+
+    // 自己的棋子在內部一律記成 OWN，於 think() 時才決定實際執 X 或 O
+    bool place(int row, int col, bool own) override {
+        if (row < 0 || row >= N || col < 0 || col >= N || board.cellCode(row, col) != 0) return false;
+        board.placePiece(row, col, own ? OWN : OPP);
+        (own ? ownStones : oppStones)++;
+        return true;
+    }
+
+    bool takeback(int row, int col) override {
+        if (row < 0 || row >= N || col < 0 || col >= N || board.cellCode(row, col) == 0) return false;
+        (board.getCell(row, col) == OWN ? ownStones : oppStones)--;
+        board.removePiece(row, col);
+        return true;
+    }
+
+    std::pair<int, int> think(long long budgetMs) override {
+        stopPonder();
+        char me = ownStones == oppStones ? 'X' : 'O'; // 雙方子數相同代表自己是先手
+        SearchEngine<N>& e = engineFor(me);
+        e.setTimeLimit(std::chrono::milliseconds(budgetMs));
+
+        BasicBoard<N> real = realBoard(me);
+        SearchResult result = e.analyze(real);
+        lastPV = result.pv;
+        lastBudget = budgetMs;
+        return result.move;
+    }
+
+    // 自己的一步下完後呼叫：假設對手照主要變化應對，先搜下一手；沒有預測就不背景思考
+    void startPonder() override {
+        if (lastPV.size() < 2 || !engine) return;
+        char me = engine->getSymbol();
+        BasicBoard<N> next = realBoard(me);
+        auto [r0, c0] = lastPV[0];
+        auto [r1, c1] = lastPV[1];
+        if (next.cellCode(r0, c0) == 0 || !next.placePiece(r1, c1, me == 'X' ? 'O' : 'X')) return;
+        if (next.isFull()) return;
+
+        stop = false;
+        engine->setTimeLimit(std::chrono::milliseconds(std::max<long long>(lastBudget * 4, 1000)));
+        ponderThread = std::thread([this, next]() mutable { engine->analyze(next); });
+    }
+
+    void stopPonder() override {
+        if (!ponderThread.joinable()) return;
+        stop = true;
+        ponderThread.join();
+        stop = false;
+    }
+
+    void setMemory(long long bytes) override {
+        stopPonder();
+        memoryMB = tableSizeFor(bytes);
+        if (engine) {
+            engine->setTableSize(memoryMB); // 會卸下存檔，重新掛上
+            attachTable();
+        }
+    }
+
+    void setTableFile(const std::string& path) override {
+        stopPonder();
+        tablePath = path;
+        if (engine) attachTable();
+    }
+
+private:
+    static const char OWN = 'X';
+    static const char OPP = 'O';
+
+    BasicBoard<N> board; // 以 OWN / OPP 記錄，與實際執子無關
+    int ownStones = 0, oppStones = 0;
+    std::unique_ptr<SearchEngine<N>> engine;
+    OpeningBook book;
+    EvalWeights weights;
+    bool hasWeights = false;
+    NnueNetwork network;
+    bool hasNetwork = false;
+    ProbCutParams probCut;
+    size_t memoryMB = 64;
+    long long lastBudget = 1000;
+    std::vector<std::pair<int, int>> lastPV;
+    std::string tablePath; // --tt-file，空字串表示不存檔
+    std::atomic<bool> stop{false};
+    std::thread ponderThread;
+
+    BasicBoard<N> realBoard(char me) const {
+        if (me == OWN) return board;
+        BasicBoard<N> real;
+        for (int r = 0; r < N; ++r)
+            for (int c = 0; c < N; ++c)
+                if (board.cellCode(r, c) != 0) real.placePiece(r, c, board.getCell(r, c) == OWN ? OPP : OWN);
+        return real;
+    }
+
+    // 執子改變（換局或換邊）才重建引擎；置換表跨步保留，讓背景思考的結果用得上
+    SearchEngine<N>& engineFor(char symbol) {
+        if (!engine || engine->getSymbol() != symbol) {
+            engine.reset(); // 先釋放舊的置換表
+            engine.reset(new SearchEngine<N>(symbol, memoryMB));
+            engine->setKeepTable(true);
+            engine->setStopFlag(&stop);
+            if (book.isOpen()) engine->setOpeningBook(&book);
+            if (hasWeights) engine->setWeights(weights);
+            if (hasNetwork) engine->setNetwork(&network);
+            engine->setProbCut(probCut);
+            attachTable();
+        }
+        return *engine;
+    }
+
+    // 存檔的指紋含執子方與評估設定，引擎設定完才掛上；執子方寫進檔名，換邊時不會互相擋掉
+    void attachTable() {
+        if (tablePath.empty()) return;
+        std::string path = tablePath + "." + std::to_string(N) + engine->getSymbol();
+        if (!engine->attachTableFile(path)) std::cerr << path << ": not a table file for these settings, keeping the table in memory\n";
+    }
+};
+
+// 任意大小的有限棋盤：稀疏棋盤與稀疏搜尋，每步成本只跟棋子數有關
+class SparseSession : public Session {
+public:
+    explicit SparseSession(int size) : board(size) {}
+
+    void reset() override {
+        board.reset();
+        ownStones = oppStones = 0;
+    }
+
+    bool place(int row, int col, bool own) override {
+        if (board.cellCode(row, col) != 0) return false;
+        board.placePiece(row, col, own ? OWN : OPP);
+        (own ? ownStones : oppStones)++;
+        return true;
+    }
+
+    bool takeback(int row, int col) override {
+        char cell = board.getCell(row, col);
+        if (cell == '.') return false;
+        (cell == OWN ? ownStones : oppStones)--;
+        board.removePiece(row, col);
+        return true;
+    }
+
+    std::pair<int, int> think(long long budgetMs) override {
+        char me = ownStones == oppStones ? 'X' : 'O';
+        if (!engine || engine->getSymbol() != me) {
+            engine.reset();
+            engine.reset(new SparseSearchEngine<>(me, memoryMB));
+        }
+        engine->setTimeLimit(std::chrono::milliseconds(budgetMs));
+
+        const char opp = me == 'X' ? 'O' : 'X';
+        SparseBoard real(board.getLimit());
+        for (const auto& s : board.getStones()) real.placePiece(s.row, s.col, s.symbol == OWN ? me : opp);
+        return engine->search(real);
+    }
+
+    void startPonder() override {}
+    void stopPonder() override {}
+
+    void setMemory(long long bytes) override {
+        memoryMB = tableSizeFor(bytes);
+        if (engine) engine->setTableSize(memoryMB);
+    }
+
+    void setTableFile(const std::string&) override {
+        std::cerr << "--tt-file is not supported by the sparse engine, keeping the table in memory\n";
+    }
+
+private:
+    static const char OWN = 'X';
+    static const char OPP = 'O';
+
+    SparseBoard board; // 以 OWN / OPP 記錄，與實際執子無關
+    int ownStones = 0, oppStones = 0;
+    std::unique_ptr<SparseSearchEngine<>> engine;
+    size_t memoryMB = 64;
+};
+
+// --record 的對局紀錄。誰執黑要等第一手才知道，所以第一手下了才開始這一盤；
+// 以另一個稀疏棋盤依實際執子判定勝負
+class MatchRecorder {
+public:
+    bool open(const std::string& path) { return writer.open(path); }
+    bool isOpen() const { return writer.isOpen(); }
+
+    // START / RESTART / BOARD：上一盤沒下完就以 Unknown 保留
+    void reset(int boardSize) {
+        if (active) writer.endGame(RecordResult::Unknown);
+        active = over = false;
+        size = boardSize;
+        board = SparseBoard(size);
+        moves.clear();
+    }
+
+    void move(int row, int col, bool own) {
+        if (!writer.isOpen() || over || (size != 15 && size != 19)) return;
+        if (moves.empty()) ownBlack = own;
+        moves.push_back({row, col, own});
+        char symbol = own == ownBlack ? 'X' : 'O';
+        board.placePiece(row, col, symbol);
+        if (!active) begin();
+        writer.addMove(row, col);
+        if (ActiveRule::isWin(board, row, col, symbol)) finish(symbol == 'X' ? RecordResult::BlackWin : RecordResult::WhiteWin);
+        else if (board.isFull()) finish(RecordResult::Draw);
+    }
+
+    // 悔棋：已寫入的這一盤以 Unknown 結束，剩下的步數重新開一盤
+    void takeback(int row, int col) {
+        if (!writer.isOpen() || moves.empty() || moves.back().row != row || moves.back().col != col) return;
+        moves.pop_back();
+        auto kept = moves;
+        reset(size);
+        for (const auto& m : kept) move(m.row, m.col, m.own);
+    }
+
+    void close() {
+        if (active) writer.endGame(RecordResult::Unknown);
+        active = false;
+        writer.close();
+    }
+
+private:
+    struct Played {
+        int row, col;
+        bool own;
+    };
+    GameRecordWriter writer;
+    SparseBoard board;
+    std::vector<Played> moves;
+    int size = 0;
+    bool ownBlack = true;
+    bool active = false;
+    bool over = false;
+
+    void begin() {
+        GameRecord info;
+        info.boardSize = size;
+        info.rule = ActiveRule::id;
+        info.black = ownBlack ? "pbrain-gomoku" : "opponent";
+        info.white = ownBlack ? "opponent" : "pbrain-gomoku";
+        writer.beginGame(info);
+        active = true;
+    }
+
+    void finish(RecordResult result) {
+        writer.endGame(result);
+        active = false;
+        over = true;
+    }
+};
+
+// 這一步可用的時間：取每步上限與剩餘時間的一部分，再扣掉回覆與行程排程的餘裕
+static long long turnBudget(const Limits& limits) {
+    long long budget = limits.turnMs > 0 ? limits.turnMs : 100;
+    if (limits.leftKnown) budget = std::min(budget, std::max(limits.leftMs / 15, 1LL));
+    else if (limits.matchMs > 0) budget = std::min(budget, limits.matchMs / 30);
+    long long margin = std::max(30LL, budget / 10);
+    return std::max(1LL, budget - margin);
+}
+
+static bool parseXY(const std::string& text, int& x, int& y) {
+    char comma;
+    std::istringstream in(text);
+    return static_cast<bool>(in >> x >> comma >> y) && comma == ',';
+}
+
+static void reply(const std::string& line) { std::cout << line << std::endl; }
+
+static std::unique_ptr<Session> makeSession(int size, bool sparse) {
+    if (size < 5) return nullptr;
+    if (!sparse && (size == 15 || size == 19)) {
+        return dispatchBoardSize(size, [](auto n) -> std::unique_ptr<Session> {
+            return std::unique_ptr<Session>(new SessionImpl<decltype(n)::value>());
+        });
+    }
+    return std::unique_ptr<Session>(new SparseSession(size));
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+    bool sparse = false;
+    MatchRecorder recorder;
+    std::string tablePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sparse") {
+            sparse = true;
+        } else if (arg == "--tt-file" && i + 1 < argc) {
+            tablePath = argv[++i];
+        } else if (arg == "--record" && i + 1 < argc) {
+            if (!recorder.open(argv[++i])) {
+                std::cerr << "Failed to open record file " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "usage: pbrain-gomoku [--sparse] [--record <games.gmr>] [--tt-file <path>]\n";
+            return 1;
+        }
+    }
+    std::unique_ptr<Session> session;
+    Limits limits;
+    int boardSize = 0;
+
+    // 回覆一步並開始背景思考；收到回覆前的時間都算在這一步
+    auto play = [&]() {
+        auto [row, col] = session->think(turnBudget(limits));
+        if (row < 0 || !session->place(row, col, true)) { // 滿盤或連珠黑棋只剩禁手
+            reply("ERROR no legal move");
+            return;
+        }
+        reply(std::to_string(col) + "," + std::to_string(row));
+        recorder.move(row, col, true);
+        session->startPonder();
+    };
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream in(line);
+        std::string command, rest;
+        in >> command;
+        std::getline(in, rest);
+        rest.erase(0, rest.find_first_not_of(' '));
+        for (auto& ch : command) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+
+        if (session) session->stopPonder();
+
+        if (command == "START") {
+            int size = std::atoi(rest.c_str());
+            session = makeSession(size, sparse);
+            if (!session) {
+                reply("ERROR unsupported board size " + rest);
+                continue;
+            }
+            if (limits.maxMemory > 0) session->setMemory(limits.maxMemory);
+            if (!tablePath.empty()) session->setTableFile(tablePath);
+            boardSize = size;
+            recorder.reset(boardSize);
+            if (recorder.isOpen() && size != 15 && size != 19) {
+                std::cerr << "Record file only supports 15x15 and 19x19, not recording " << size << "x" << size << "\n";
+            }
+            reply("OK");
+        } else if (command == "END") {
+            break;
+        } else if (command == "ABOUT") {
+            reply("name=\"gomoku\", version=\"1.0\", author=\"GomokuProject\", country=\"TW\"");
+        } else if (command == "INFO") {
+            std::istringstream info(rest);
+            std::string key;
+            long long value = 0;
+            info >> key >> value;
+            if (key == "timeout_turn") limits.turnMs = value;
+            else if (key == "timeout_match") limits.matchMs = value;
+            else if (key == "time_left") {
+                limits.leftMs = value;
+                limits.leftKnown = true;
+            } else if (key == "max_memory") {
+                limits.maxMemory = value;
+                if (session) session->setMemory(value);
+            }
+            // 其他（game_type、rule、folder、evaluate）目前不影響引擎
+        } else if (!session) {
+            reply("ERROR no START received");
+        } else if (command == "RESTART") {
+            session->reset();
+            recorder.reset(boardSize);
+            reply("OK");
+        } else if (command == "BEGIN") {
+            play();
+        } else if (command == "TURN") {
+            int x, y;
+            if (!parseXY(rest, x, y) || !session->place(y, x, false)) {
+                reply("ERROR invalid move " + rest);
+                continue;
+            }
+            recorder.move(y, x, false);
+            play();
+        } else if (command == "TAKEBACK") {
+            int x, y;
+            if (parseXY(rest, x, y) && session->takeback(y, x)) {
+                recorder.takeback(y, x);
+                reply("OK");
+            } else {
+                reply("ERROR invalid takeback " + rest);
+            }
+        } else if (command == "BOARD") {
+            // 之後每行 "x,y,field"（1 自己、2 對手、3 連續棋局的對手），直到 DONE
+            session->reset();
+            recorder.reset(boardSize);
+            bool ok = true;
+            while (std::getline(std::cin, line)) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line == "DONE") break;
+                int x, y, field;
+                char c1, c2;
+                std::istringstream cell(line);
+                if (!(cell >> x >> c1 >> y >> c2 >> field) || !session->place(y, x, field == 1)) ok = false;
+                else recorder.move(y, x, field == 1);
+            }
+            if (!ok) reply("MESSAGE ignored invalid BOARD entries");
+            play();
+        } else {
+            reply("UNKNOWN " + command);
+        }
+    }
+    recorder.close();
+    return 0;
+}
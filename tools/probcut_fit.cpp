@@ -0,0 +1,207 @@
+// ProbCut 參數擬合工具
+//
+//   probcut_fit <games.gmr>... -o probcut.params [--pairs 4:2,5:3,6:2] [--threshold 1.5]
+//               [--skip 6] [--every 4] [--max-positions 2000] [--threads N] [--hash 16]
+//
+// 從棋譜（通常是自我對局）取樣局面，每個局面分別以淺層與深層搜尋求值，
+// 對每組「深度 d : 淺層 s」做最小平方法 deep = a * shallow + b，殘差標準差即 sigma。
+// 搜尋用引擎預設的走法寬度與評估（工作目錄下的 eval.params / eval.nnue 不會自動載入），
+// 分出勝負的局面（直接獲勝、擋四或勝負分數）不列入樣本
+#include "GameRecord.hpp"
+#include "SearchEngine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SampleOptions {
+    int skip = 6;  // 開局前幾手不取
+    int every = 4; // 每隔幾手取一次，同一盤的相鄰局面太相似
+    size_t maxPositions = 2000;
+};
+
+struct Position {
+    int size;
+    std::vector<std::pair<int, int>> moves;
+};
+
+static void usage() {
+    std::cerr << "usage: probcut_fit <games.gmr>... -o <probcut.params> [--pairs <d:s,...>] [--threshold <t>]\n"
+                 "                   [--skip <plies>] [--every <n>] [--max-positions <n>] [--threads <n>] [--hash <MB>]\n";
+}
+
+// "4:2,5:3" → {{4, 2}, {5, 3}}
+static bool parsePairs(const std::string& text, std::vector<std::pair<int, int>>& pairs) {
+    std::istringstream in(text);
+    std::string field;
+    pairs.clear();
+    while (std::getline(in, field, ',')) {
+        size_t colon = field.find(':');
+        if (colon == std::string::npos) return false;
+        int d = std::stoi(field.substr(0, colon)), s = std::stoi(field.substr(colon + 1));
+        if (s < 1 || s >= d || d > ProbCutParams::MAX_DEPTH) return false;
+        pairs.emplace_back(d, s);
+    }
+    return !pairs.empty();
+}
+
+static bool loadPositions(const std::string& path, const SampleOptions& options, std::vector<Position>& out) {
+    GameRecordReader reader;
+    if (!reader.open(path)) return false;
+    GameRecordReader::GameView game;
+    while (reader.next(game) && out.size() < options.maxPositions) {
+        Position p{game.boardSize(), {}};
+        for (int ply = 0; ply < game.moveCount() && out.size() < options.maxPositions; ++ply) {
+            if (ply >= options.skip && (ply - options.skip) % options.every == 0) out.push_back(p);
+            p.moves.push_back(game.move(ply));
+        }
+    }
+    return true;
+}
+
+// 每個局面在各深度的分數（輪到的一方的角度）；任一深度不是一般搜尋的結果就整個局面捨棄
+template <int N>
+static bool scorePosition(const Position& p, const std::vector<int>& depths, size_t hashMB, std::map<int, int>& scores) {
+    BasicBoard<N> board;
+    char turn = 'X';
+    for (auto [r, c] : p.moves) {
+        if (!board.placePiece(r, c, turn)) return false;
+        if (ActiveRule::isWin(board, r, c, turn)) return false; // 已分勝負
+        turn = (turn == 'X') ? 'O' : 'X';
+    }
+    if (board.isFull()) return false;
+
+    SearchEngine<N> engine(turn, hashMB);
+    engine.setThreads(1);
+    engine.setTimeLimit(std::chrono::hours(1));
+    for (int d : depths) {
+        engine.setDepth(d - 1); // 根節點本身佔一層：根的剩餘深度 = setDepth + 1
+        SearchResult r = engine.analyze(board);
+        if (std::string(r.source) != "search" || std::abs(r.score) >= 100000) return false;
+        scores[d] = r.score;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> inputs;
+    std::string output;
+    std::vector<std::pair<int, int>> pairs = {{4, 2}, {5, 3}, {6, 2}};
+    SampleOptions options;
+    ProbCutParams params;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t hashMB = 16;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "-o") output = next();
+            else if (arg == "--pairs") {
+                if (!parsePairs(next(), pairs)) throw std::invalid_argument(arg);
+            } else if (arg == "--threshold") params.threshold = std::stod(next());
+            else if (arg == "--skip") options.skip = std::max(0, std::stoi(next()));
+            else if (arg == "--every") options.every = std::max(1, std::stoi(next()));
+            else if (arg == "--max-positions") options.maxPositions = std::stoul(next());
+            else if (arg == "--threads") threads = std::max(1, std::stoi(next()));
+            else if (arg == "--hash") hashMB = std::stoul(next());
+            else if (arg[0] != '-') inputs.push_back(arg);
+            else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 1;
+    }
+    if (inputs.empty() || output.empty()) {
+        usage();
+        return 1;
+    }
+
+    std::vector<Position> positions;
+    for (const auto& path : inputs) {
+        if (!loadPositions(path, options, positions)) {
+            std::cerr << "Cannot open " << path << "\n";
+            return 1;
+        }
+    }
+    std::set<int> depthSet;
+    for (auto [d, s] : pairs) {
+        depthSet.insert(d);
+        depthSet.insert(s);
+    }
+    const std::vector<int> depths(depthSet.begin(), depthSet.end());
+    std::cout << "positions: " << positions.size() << ", depths:";
+    for (int d : depths) std::cout << " " << d;
+    std::cout << "\n";
+
+    // 各執行緒輪流領取局面，結果依局面編號存放
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::map<int, int>> results(positions.size());
+    std::vector<char> valid(positions.size(), 0);
+    std::atomic<size_t> nextIndex{0};
+    auto worker = [&]() {
+        for (size_t i = nextIndex++; i < positions.size(); i = nextIndex++) {
+            try {
+                valid[i] = dispatchBoardSize(positions[i].size, [&](auto n) {
+                    return scorePosition<decltype(n)::value>(positions[i], depths, hashMB, results[i]);
+                });
+            } catch (const std::invalid_argument&) {
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    size_t samples = std::count(valid.begin(), valid.end(), 1);
+    std::cout << "scored " << samples << " positions in "
+              << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start).count() << " s\n";
+
+    for (auto [d, s] : pairs) {
+        double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            if (!valid[i]) continue;
+            double x = results[i][s], y = results[i][d];
+            n++;
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+            syy += y * y;
+        }
+        double varX = sxx - sx * sx / n, varY = syy - sy * sy / n, cov = sxy - sx * sy / n;
+        if (n < 10 || varX <= 0 || cov <= 0) {
+            std::cout << "depth " << d << " <- " << s << ": not enough signal (" << n << " samples), skipped\n";
+            continue;
+        }
+        ProbCutParams::Pair& p = params.pairs[d];
+        p.shallow = s;
+        p.a = cov / varX;
+        p.b = (sy - p.a * sx) / n;
+        double residual = std::max(0.0, varY - p.a * cov); // 殘差平方和
+        p.sigma = std::sqrt(residual / std::max(1.0, n - 2));
+        std::cout << "depth " << d << " <- " << s << ": a=" << p.a << " b=" << p.b << " sigma=" << p.sigma
+                  << " r=" << cov / std::sqrt(varX * varY) << " (" << n << " samples)\n";
+    }
+
+    if (!params.enabled()) {
+        std::cerr << "No depth pair could be fitted\n";
+        return 1;
+    }
+    if (!params.save(output)) {
+        std::cerr << "Cannot write " << output << "\n";
+        return 1;
+    }
+    std::cout << "wrote " << output << "\n";
+    return 0;
+}
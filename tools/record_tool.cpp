@@ -0,0 +1,193 @@
+// 棋譜工具：二進位棋譜 (.gmr) 與文字格式互轉、統計
+//
+//   record_tool stats  <games.gmr>
+//   record_tool export <games.gmr> [--format text|psq] [--game <i>]
+//   record_tool import <file>... -o <games.gmr> [--format text|psq] [--size 15] [--rule freestyle|standard|renju]
+//
+// text 格式每行一盤，如 "h8 i9 j10"；psq 為 Piskvork 棋譜，一個檔案一盤。
+// 匯入時依 --rule（預設為建置的規則）重播判定勝負並寫進紀錄的規則欄位；
+// 有不合法的步（含禁手）或棋盤不是 15 / 19 路的棋局略過並說明原因
+#include "GameRecord.hpp"
+#include "SearchEngine.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static void usage() {
+    std::cerr << "usage: record_tool stats <games.gmr>\n"
+                 "       record_tool export <games.gmr> [--format text|psq] [--game <i>]\n"
+                 "       record_tool import <file>... -o <games.gmr> [--format text|psq] [--size 15|19]\n"
+                 "                          [--rule freestyle|standard|renju]\n";
+}
+
+// 在 Rule 下重播判定勝負；有不合法的步（含禁手）就回傳 false
+template <class Rule, int N>
+static bool replay(GameRecord& game, std::string& error) {
+    BasicBoard<N> board;
+    char turn = 'X';
+    game.result = RecordResult::Unknown;
+    for (size_t i = 0; i < game.moves.size(); ++i) {
+        auto [r, c] = game.moves[i];
+        if (r < 0 || r >= N || c < 0 || c >= N || Rule::isForbidden(board, r, c, turn) || !board.placePiece(r, c, turn)) {
+            error = "illegal move " + std::to_string(i + 1) + " under " + Rule::name;
+            return false;
+        }
+        if (Rule::isWin(board, r, c, turn)) {
+            game.result = (turn == 'X') ? RecordResult::BlackWin : RecordResult::WhiteWin;
+            break;
+        }
+        turn = (turn == 'X') ? 'O' : 'X';
+    }
+    if (game.result == RecordResult::Unknown && board.isFull()) game.result = RecordResult::Draw;
+    return true;
+}
+
+// 依 game.rule 重播；棋譜格式只收 15 / 19 路，其他大小（例如 Gomocup 預設的 20 路）回傳 false
+static bool adjudicate(GameRecord& game, std::string& error) {
+    if (game.boardSize != 15 && game.boardSize != 19) {
+        error = "unsupported board size " + std::to_string(game.boardSize);
+        return false;
+    }
+    return dispatchBoardSize(game.boardSize, [&](auto n) {
+        constexpr int N = decltype(n)::value;
+        switch (game.rule) {
+            case StandardRule::id: return replay<StandardRule, N>(game, error);
+            case RenjuRule::id: return replay<RenjuRule, N>(game, error);
+            default: return replay<FreestyleRule, N>(game, error);
+        }
+    });
+}
+
+static int stats(const std::string& path) {
+    GameRecordReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Cannot open " << path << "\n";
+        return 1;
+    }
+    long long games = 0, moves = 0, results[4] = {0, 0, 0, 0};
+    GameRecordReader::GameView game;
+    while (reader.next(game)) {
+        games++;
+        moves += game.moveCount();
+        results[static_cast<int>(game.result())]++;
+    }
+    std::cout << "games: " << games << "\n"
+              << "moves: " << moves << "\n"
+              << "black wins: " << results[1] << "\n"
+              << "white wins: " << results[2] << "\n"
+              << "draws: " << results[3] << "\n"
+              << "unknown: " << results[0] << "\n";
+    if (reader.tell() != reader.size()) std::cout << "warning: trailing partial record\n";
+    return 0;
+}
+
+static int exportGames(const std::string& path, const std::string& format, long long only) {
+    GameRecordReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Cannot open " << path << "\n";
+        return 1;
+    }
+    GameRecordReader::GameView game;
+    for (long long i = 0; reader.next(game); ++i) {
+        if (only >= 0 && i != only) continue;
+        GameRecord record = game.toRecord();
+        if (format == "psq") std::cout << formatPsq(record);
+        else std::cout << formatMoveText(record) << "\n";
+        if (only >= 0) break;
+    }
+    return 0;
+}
+
+static int importGames(const std::vector<std::string>& inputs, const std::string& output,
+                       const std::string& format, int size, uint8_t rule) {
+    GameRecordWriter writer;
+    if (!writer.open(output)) {
+        std::cerr << "Cannot open " << output << "\n";
+        return 1;
+    }
+    int imported = 0, skipped = 0;
+    for (const auto& path : inputs) {
+        std::ifstream in(path);
+        if (!in) {
+            std::cerr << "Cannot open " << path << "\n";
+            skipped++;
+            continue;
+        }
+        if (format == "psq") {
+            std::stringstream buf;
+            buf << in.rdbuf();
+            GameRecord game;
+            std::string error = "not a psq file";
+            bool ok = parsePsq(buf.str(), game);
+            game.rule = rule;
+            if (ok && adjudicate(game, error) && writer.write(game)) {
+                imported++;
+            } else {
+                std::cerr << path << ": " << error << ", skipped\n";
+                skipped++;
+            }
+            continue;
+        }
+        std::string line;
+        for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+            if (line.empty() || line[0] == '#') continue;
+            GameRecord game;
+            game.boardSize = size;
+            game.rule = rule;
+            std::string error = "invalid move text";
+            if (parseMoveText(line, size, game.moves) && adjudicate(game, error) && writer.write(game)) {
+                imported++;
+            } else {
+                std::cerr << path << ":" << lineNo << ": " << error << ", skipped\n";
+                skipped++;
+            }
+        }
+    }
+    std::cout << "Imported " << imported << " games (" << skipped << " skipped)\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+    std::string command = argv[1];
+    std::string format = "text", output;
+    std::vector<std::string> inputs;
+    long long only = -1;
+    int size = 15;
+    std::string ruleName = ActiveRule::name;
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "--format") format = next();
+            else if (arg == "--game") only = std::stoll(next());
+            else if (arg == "--size") size = std::stoi(next());
+            else if (arg == "--rule") ruleName = next();
+            else if (arg == "-o") output = next();
+            else inputs.push_back(arg);
+        }
+
+        if (command == "stats" && inputs.size() == 1) return stats(inputs[0]);
+        if (command == "export" && inputs.size() == 1) return exportGames(inputs[0], format, only);
+        uint8_t rule;
+        if (ruleName == FreestyleRule::name) rule = FreestyleRule::id;
+        else if (ruleName == StandardRule::name) rule = StandardRule::id;
+        else if (ruleName == RenjuRule::name) rule = RenjuRule::id;
+        else {
+            std::cerr << "Unknown rule " << ruleName << "\n";
+            return 1;
+        }
+        if (command == "import" && !inputs.empty() && !output.empty()) return importGames(inputs, output, format, size, rule);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    usage();
+    return 1;
+}
@@ -0,0 +1,316 @@
+// 搜尋樹追蹤檔工具（追蹤檔由 SearchEngine::setTrace 產生，例如 batch_analyze --trace）
+//
+//   trace_tool summary <trace.bin>                 每次搜尋的節點數、各層展開數、結束原因與排序品質
+//   trace_tool dot  <trace.bin> [--search k] [--path "h8 i9"] [--depth 2] [--max-nodes 20000] [-o out.dot]
+//   trace_tool json <trace.bin> [--search k] [--path "h8 i9"] [--depth 2] [--max-nodes 20000] [-o out.json]
+//
+// dot / json 只輸出選定的子樹：--search 預設為最後一次搜尋，--path 為從根局面起的走法
+// （第一步即根節點走法，不給則從根開始），--depth 為往下展開的層數。
+// 兩者都是一邊讀一邊處理，只保留選到的節點，檔案再大也不必整棵樹放進記憶體
+#include "GameRecord.hpp"
+#include "SearchTrace.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+static const char* REASONS[] = {"leaf", "tt", "cutoff", "exhausted", "win", "timeout", "probcut"};
+static const int REASON_COUNT = 7;
+
+static void usage() {
+    std::cerr << "usage: trace_tool summary <trace.bin>\n"
+                 "       trace_tool dot|json <trace.bin> [--search <k>] [--path \"<moves>\"] [--depth <n>]\n"
+                 "                  [--max-nodes <n>] [-o <file>]\n";
+}
+
+static std::string moveText(int size, int row, int col) {
+    GameRecord one;
+    one.boardSize = size;
+    one.moves.emplace_back(row, col);
+    return formatMoveText(one);
+}
+
+// 根局面只記得每顆子的位置與顏色（沒有手順），依顏色分開列出，例如 "X: h8 i9 / O: j10"
+static std::string positionText(int size, const std::vector<std::pair<int, char>>& stones) {
+    std::string text[2];
+    for (auto [cell, color] : stones) text[color == 'X' ? 0 : 1] += " " + moveText(size, cell / size, cell % size);
+    return "X:" + text[0] + " / O:" + text[1];
+}
+
+// --- summary --- //
+
+struct SearchStats {
+    int depth = 0;
+    char mover = '?';
+    std::string position;
+    uint64_t nodes = 0, ttHits = 0;
+    uint64_t reasons[REASON_COUNT] = {};
+    std::vector<uint64_t> perPly;
+    uint64_t cutoffs = 0, firstMoveCutoffs = 0, cutoffChildren = 0;
+};
+
+static int summary(SearchTraceReader& reader) {
+    std::map<uint32_t, SearchStats> searches;
+    SearchTraceReader::Chunk chunk;
+    SearchTraceReader::Record record;
+    while (reader.next(chunk)) {
+        SearchStats& s = searches[chunk.search];
+        size_t pos = 0;
+        while (SearchTraceReader::parse(chunk.data, pos, record)) {
+            if (record.tag == SearchTrace::SEARCH) {
+                s.depth = record.searchDepth;
+                s.mover = record.mover;
+                s.position = positionText(reader.boardSize(), record.stones);
+            } else if (record.tag == SearchTrace::ENTER) {
+                if (s.perPly.size() <= static_cast<size_t>(record.ply)) s.perPly.resize(record.ply + 1);
+                s.perPly[record.ply]++;
+            } else if (record.tag == SearchTrace::EXIT) {
+                s.nodes++;
+                if (record.flags & SearchTrace::TT_HIT) s.ttHits++;
+                if (record.reason < REASON_COUNT) s.reasons[record.reason]++;
+                if (record.reason == SearchTrace::CUTOFF) {
+                    s.cutoffs++;
+                    s.cutoffChildren += record.children;
+                    if (record.children == 1) s.firstMoveCutoffs++;
+                }
+            }
+        }
+    }
+
+    for (auto& [id, s] : searches) {
+        std::cout << "search " << id << ": depth " << s.depth << ", " << s.mover << " to move, position \""
+                  << s.position << "\"\n";
+        std::cout << "  nodes " << s.nodes << ", tt hits " << s.ttHits << "\n  per ply:";
+        for (size_t ply = 1; ply < s.perPly.size(); ++ply) std::cout << " " << s.perPly[ply];
+        std::cout << "\n  reasons:";
+        for (int r = 0; r < REASON_COUNT; ++r)
+            if (s.reasons[r]) std::cout << " " << REASONS[r] << "=" << s.reasons[r];
+        // 第一步就剪掉的比例越高，排序越好
+        if (s.cutoffs) {
+            std::cout << "\n  cutoffs: first move " << 100.0 * s.firstMoveCutoffs / s.cutoffs << "%, mean moves tried "
+                      << static_cast<double>(s.cutoffChildren) / s.cutoffs;
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
+
+// --- 子樹輸出 --- //
+
+struct Node {
+    int row = -1, col = -1, ply = 0, depth = 0;
+    int alpha = 0, beta = 0, score = 0;
+    int reason = -1, flags = 0, searched = 0;
+    int parent = -1;
+    std::vector<int> children;
+};
+
+struct Selection {
+    uint32_t search = 0;
+    std::vector<std::pair<int, int>> path;
+    int depth = 2;
+    size_t maxNodes = 20000;
+};
+
+// 每條執行緒的串流各自維護目前的走法路徑；只有落在選定子樹內的節點才保留
+struct Stream {
+    std::vector<std::pair<int, int>> path; // path[i] 為 ply i+1 的走法
+    std::vector<int> captured;             // 與 path 對齊：保留的節點索引或 -1
+};
+
+static bool collect(SearchTraceReader& reader, const Selection& sel, std::vector<Node>& nodes, std::string& position) {
+    const int base = static_cast<int>(sel.path.size()); // 選定節點的 ply（0 為根局面）
+    nodes.clear();
+    nodes.emplace_back(); // nodes[0] 為選定的節點；path 為空時是虛擬的根節點
+    bool found = base == 0, truncated = false;
+
+    std::map<uint16_t, Stream> streams;
+    SearchTraceReader::Chunk chunk;
+    SearchTraceReader::Record record;
+    while (reader.next(chunk)) {
+        if (chunk.search != sel.search) continue;
+        Stream& stream = streams[chunk.thread];
+        size_t pos = 0;
+        while (SearchTraceReader::parse(chunk.data, pos, record)) {
+            if (record.tag == SearchTrace::SEARCH) {
+                position = positionText(reader.boardSize(), record.stones);
+            } else if (record.tag == SearchTrace::ENTER) {
+                const int ply = record.ply;
+                stream.path.resize(ply - 1);
+                stream.captured.resize(ply - 1, -1);
+                stream.path.emplace_back(record.row, record.col);
+
+                int index = -1;
+                bool inside = ply >= base && ply <= base + sel.depth &&
+                              std::equal(sel.path.begin(), sel.path.end(), stream.path.begin());
+                if (inside && ply == base) {
+                    index = 0;
+                    found = true;
+                } else if (inside) {
+                    int parent = ply - 1 == base ? 0 : stream.captured[ply - 2];
+                    if (parent >= 0 && nodes.size() < sel.maxNodes) {
+                        index = static_cast<int>(nodes.size());
+                        nodes.emplace_back();
+                        nodes[parent].children.push_back(index);
+                        nodes[index].parent = parent;
+                    } else if (parent >= 0) {
+                        truncated = true;
+                    }
+                }
+                if (index >= 0) {
+                    Node& n = nodes[index];
+                    n.row = record.row;
+                    n.col = record.col;
+                    n.ply = ply;
+                    n.depth = record.depth;
+                    n.alpha = record.alpha;
+                    n.beta = record.beta;
+                }
+                stream.captured.push_back(index);
+            } else if (record.tag == SearchTrace::EXIT && !stream.captured.empty()) {
+                int index = stream.captured.back();
+                if (index >= 0) {
+                    Node& n = nodes[index];
+                    n.score = record.score;
+                    n.reason = record.reason;
+                    n.flags = record.flags;
+                    n.searched = record.children;
+                }
+                stream.captured.pop_back();
+                stream.path.pop_back();
+            }
+        }
+    }
+    if (truncated) std::cerr << "Subtree truncated at " << sel.maxNodes << " nodes (use --max-nodes or --depth)\n";
+    return found;
+}
+
+static std::string bound(int v) {
+    if (v == std::numeric_limits<int>::min()) return "-inf";
+    if (v == std::numeric_limits<int>::max()) return "inf";
+    return std::to_string(v);
+}
+
+static void writeDot(std::ostream& out, const std::vector<Node>& nodes, int size, const std::string& position) {
+    static const char* COLORS[] = {"gray90", "lightblue", "salmon", "white", "gold", "plum", "palegreen"};
+    out << "digraph search {\n  node [shape=box, style=filled, fontname=\"monospace\", fontsize=10];\n";
+    out << "  label=\"" << position << "\";\n";
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const Node& n = nodes[i];
+        out << "  n" << i << " [label=\"" << (n.row >= 0 ? moveText(size, n.row, n.col) : "root");
+        if (n.reason >= 0) {
+            out << "\\nd=" << n.depth << " [" << bound(n.alpha) << ", " << bound(n.beta) << "]\\n"
+                << n.score << " " << REASONS[n.reason] << ((n.flags & SearchTrace::TT_HIT) ? " tt" : "");
+        }
+        out << "\", fillcolor=" << (n.reason >= 0 ? COLORS[n.reason] : "white") << "];\n";
+        for (int child : n.children) out << "  n" << i << " -> n" << child << ";\n";
+    }
+    out << "}\n";
+}
+
+static void writeJson(std::ostream& out, const std::vector<Node>& nodes, int index, int size) {
+    const Node& n = nodes[index];
+    out << "{\"move\":" << (n.row >= 0 ? "\"" + moveText(size, n.row, n.col) + "\"" : "null") << ",\"ply\":" << n.ply;
+    if (n.reason >= 0) {
+        out << ",\"depth\":" << n.depth << ",\"alpha\":" << n.alpha << ",\"beta\":" << n.beta << ",\"score\":" << n.score
+            << ",\"reason\":\"" << REASONS[n.reason] << "\",\"tt_hit\":" << ((n.flags & SearchTrace::TT_HIT) ? "true" : "false")
+            << ",\"maximizing\":" << ((n.flags & SearchTrace::MAXIMIZING) ? "true" : "false") << ",\"searched\":" << n.searched;
+    }
+    out << ",\"children\":[";
+    for (size_t i = 0; i < n.children.size(); ++i) {
+        if (i) out << ",";
+        writeJson(out, nodes, n.children[i], size);
+    }
+    out << "]}";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+    std::string command = argv[1], input = argv[2], output, pathText;
+    Selection sel;
+    bool haveSearch = false;
+
+    try {
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "--search") {
+                sel.search = static_cast<uint32_t>(std::stoul(next()));
+                haveSearch = true;
+            } else if (arg == "--path") pathText = next();
+            else if (arg == "--depth") sel.depth = std::max(0, std::stoi(next()));
+            else if (arg == "--max-nodes") sel.maxNodes = std::max<size_t>(1, std::stoul(next()));
+            else if (arg == "-o") output = next();
+            else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 1;
+    }
+
+    SearchTraceReader reader;
+    if (!reader.open(input)) {
+        std::cerr << "Cannot read trace " << input << "\n";
+        return 1;
+    }
+    if (command == "summary") return summary(reader);
+    if (command != "dot" && command != "json") {
+        usage();
+        return 1;
+    }
+
+    std::replace(pathText.begin(), pathText.end(), ',', ' ');
+    if (!parseMoveText(pathText, reader.boardSize(), sel.path)) {
+        std::cerr << "Invalid path \"" << pathText << "\"\n";
+        return 1;
+    }
+    if (!haveSearch) {
+        // 先只掃資料塊標頭找出最後一次搜尋
+        uint32_t search;
+        uint16_t thread;
+        bool any = false;
+        while (reader.skip(search, thread)) {
+            sel.search = any ? std::max(sel.search, search) : search;
+            any = true;
+        }
+        if (!any) {
+            std::cerr << input << ": no searches recorded\n";
+            return 1;
+        }
+        reader.open(input);
+    }
+
+    std::vector<Node> nodes;
+    std::string position;
+    if (!collect(reader, sel, nodes, position)) {
+        std::cerr << "Path \"" << pathText << "\" was not expanded in search " << sel.search << "\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file) {
+            std::cerr << "Cannot write " << output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+    if (command == "dot") {
+        writeDot(out, nodes, reader.boardSize(), position);
+    } else {
+        out << "{\"search\":" << sel.search << ",\"position\":\"" << position << "\",\"tree\":";
+        writeJson(out, nodes, 0, reader.boardSize());
+        out << "}\n";
+    }
+    return 0;
+}